@@ -0,0 +1,143 @@
+#include <utility>
+
+#include "async_buffer.h"
+
+using std::mutex;
+using std::swap;
+using std::unique_lock;
+
+AsyncInputBuffer::AsyncInputBuffer(std::istream &input, int capacity):
+    InputBuffer(input, capacity),
+    back_size_(0),
+    back_ready_(false),
+    stop_(false)
+{
+    back_ = new char[capacity_];
+    reader_ = std::thread(&AsyncInputBuffer::read_loop, this);
+}
+
+AsyncInputBuffer::~AsyncInputBuffer()
+{
+    {
+        unique_lock<mutex> lock(mutex_);
+        stop_ = true;
+    }
+    ready_.notify_all();
+    reader_.join();
+    delete []back_;
+}
+
+void AsyncInputBuffer::read_loop()
+{
+    unique_lock<mutex> lock(mutex_);
+
+    while (true) {
+        while (back_ready_ && !stop_) {
+            ready_.wait(lock);
+        }
+        if (stop_) {
+            return;
+        }
+
+        //back_ belongs to this thread until back_ready_ is set
+        lock.unlock();
+        input_.read(back_, capacity_);
+        int size = input_.gcount();
+        lock.lock();
+
+        back_size_ = size;
+        back_ready_ = true;
+        ready_.notify_all();
+        if (!size) {
+            return;
+        }
+    }
+}
+
+void AsyncInputBuffer::refill()
+{
+    unique_lock<mutex> lock(mutex_);
+
+    while (!back_ready_) {
+        ready_.wait(lock);
+    }
+    swap(buf_, back_);
+    size_ = back_size_;
+    current_ = 0;
+    //at the end of input the reader has exited, keep reporting it
+    if (size_) {
+        back_ready_ = false;
+        ready_.notify_all();
+    }
+}
+
+AsyncOutputBuffer::AsyncOutputBuffer(std::ostream &output, int capacity):
+    OutputBuffer(output, capacity),
+    back_size_(0),
+    pending_(false),
+    stop_(false)
+{
+    back_ = new char[capacity_];
+    writer_ = std::thread(&AsyncOutputBuffer::write_loop, this);
+}
+
+AsyncOutputBuffer::~AsyncOutputBuffer()
+{
+    flush();
+    {
+        unique_lock<mutex> lock(mutex_);
+        stop_ = true;
+    }
+    ready_.notify_all();
+    writer_.join();
+    delete []back_;
+}
+
+void AsyncOutputBuffer::write_loop()
+{
+    unique_lock<mutex> lock(mutex_);
+
+    while (true) {
+        while (!pending_ && !stop_) {
+            ready_.wait(lock);
+        }
+        if (!pending_) {
+            return;
+        }
+
+        lock.unlock();
+        output_.write(back_, back_size_);
+        lock.lock();
+
+        pending_ = false;
+        ready_.notify_all();
+    }
+}
+
+void AsyncOutputBuffer::drain()
+{
+    unique_lock<mutex> lock(mutex_);
+
+    while (pending_) {
+        ready_.wait(lock);
+    }
+    swap(buf_, back_);
+    back_size_ = current_;
+    current_ = 0;
+    pending_ = true;
+    ready_.notify_all();
+}
+
+void AsyncOutputBuffer::flush()
+{
+    overflow();
+
+    StatsClock::time_point start = StatsClock::now();
+    unique_lock<mutex> lock(mutex_);
+    while (pending_) {
+        ready_.wait(lock);
+    }
+    if (stats_) {
+        stats_->write_seconds += seconds_since(start);
+    }
+}
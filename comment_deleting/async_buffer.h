@@ -0,0 +1,55 @@
+#ifndef ASYNC_BUFFER_H
+#define ASYNC_BUFFER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "buffer.h"
+
+/*
+ * Double-buffered input: a reader thread fills the back buffer
+ * while the parser consumes the front one; refill() swaps them.
+ */
+class AsyncInputBuffer : public InputBuffer {
+private:
+    char *back_;
+    int back_size_;
+    bool back_ready_;
+    bool stop_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::thread reader_;
+
+    void read_loop();
+protected:
+    void refill();
+public:
+    AsyncInputBuffer(std::istream &input, int capacity);
+    ~AsyncInputBuffer();
+};
+
+/*
+ * Double-buffered output: a full buffer is handed to a writer thread
+ * and the parser keeps filling the other one.
+ */
+class AsyncOutputBuffer : public OutputBuffer {
+private:
+    char *back_;
+    int back_size_;
+    bool pending_;
+    bool stop_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::thread writer_;
+
+    void write_loop();
+protected:
+    void drain();
+public:
+    AsyncOutputBuffer(std::ostream &output, int capacity);
+    ~AsyncOutputBuffer();
+    void flush();
+};
+
+#endif // ASYNC_BUFFER_H
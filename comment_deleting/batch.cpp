@@ -0,0 +1,136 @@
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <streambuf>
+#include <vector>
+
+#include "batch.h"
+#include "hash.h"
+#include "mapped_file.h"
+
+using std::cerr;
+using std::ifstream;
+using std::ofstream;
+using std::string;
+using std::vector;
+
+static string file_name(const string &path)
+{
+    size_t slash = path.find_last_of('/');
+
+    return (slash == string::npos) ? path : path.substr(slash + 1);
+}
+
+// An output path may be a hard link into the cache left by an earlier --link
+// run, so it is unlinked first instead of being truncated in place.
+static void open_output(ofstream &output, const string &path)
+{
+    unlink(path.c_str());
+    output.open(path.c_str(), std::ios::binary);
+}
+
+static bool copy_file(const string &from, const string &to)
+{
+    ifstream input(from.c_str(), std::ios::binary);
+    ofstream output;
+
+    if (!input) {
+        return false;
+    }
+    open_output(output, to);
+    output << input.rdbuf();
+    output.close();
+    return input && output;
+}
+
+static bool strip_file(const string &from, const string &to, StripFunction strip, StripStats *stats)
+{
+    ifstream input(from.c_str(), std::ios::binary);
+    ofstream output;
+
+    if (!input) {
+        return false;
+    }
+    open_output(output, to);
+    if (!output) {
+        return false;
+    }
+    strip(input, output, stats);
+    output.close();
+    return !input.bad() && output;
+}
+
+//istream source over bytes in memory, without copying them
+class MemoryStreamBuffer : public std::streambuf {
+public:
+    MemoryStreamBuffer(char *begin, size_t size)
+    {
+        setg(begin, begin, begin + size);
+    }
+};
+
+static bool strip_cached(const string &from, const string &to, StripFunction strip,
+                         uint64_t seed, StripCache &cache, bool link, StripStats *stats)
+{
+    try {
+        MappedFile content(from);
+        uint64_t hash = xxhash64(content.data(), content.size(), seed);
+        string cached = cache.path(hash);
+
+        //the index may outlive a deleted cache file, strip again then
+        if (!cache.find(hash, content.size()) || access(cached.c_str(), R_OK)) {
+            MemoryStreamBuffer buffer(content.data(), content.size());
+            std::istream source(&buffer);
+            char suffix[32];
+            snprintf(suffix, sizeof(suffix), ".%ld.tmp", (long)getpid());
+            string temporary = cached + suffix;
+            ofstream output;
+
+            open_output(output, temporary);
+            if (!output) {
+                return false;
+            }
+            strip(source, output, stats);
+            output.close();
+            if (!output || rename(temporary.c_str(), cached.c_str())) {
+                unlink(temporary.c_str());
+                return false;
+            }
+            cache.insert(hash, content.size());
+        }
+
+        if (link) {
+            unlink(to.c_str());
+            if (!::link(cached.c_str(), to.c_str())) {
+                return true;
+            }
+        }
+        return copy_file(cached, to);
+    } catch (const std::runtime_error &) {
+        return false;
+    }
+}
+
+int strip_files(const vector<string> &inputs, const string &output_directory,
+                StripFunction strip, const char *language, StripCache *cache, bool link,
+                StripStats *stats)
+{
+    uint64_t seed = xxhash64(language, strlen(language));
+    int failed = 0;
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        string output = output_directory + "/" + file_name(inputs[i]);
+        bool done = cache ? strip_cached(inputs[i], output, strip, seed, *cache, link, stats)
+                          : strip_file(inputs[i], output, strip, stats);
+        if (!done) {
+            cerr << "cannot strip " << inputs[i] << "\n";
+            ++failed;
+        }
+    }
+
+    return failed;
+}
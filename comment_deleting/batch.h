@@ -0,0 +1,27 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "stats.h"
+#include "strip_cache.h"
+
+typedef void (*StripFunction)(std::istream &input, std::ostream &output, StripStats *stats);
+
+/*
+ * Strip every input with strip (e.g. strip_comments<CLanguage>) into output_directory/<file name>.
+ * With a cache, unchanged inputs are served from it instead of being parsed,
+ * by copying or, if link is set, by hard-linking the cached file
+ * (linked outputs share storage with the cache and must not be edited).
+ * Cache entries are keyed by the input and the language name.
+ * Counters of the files actually parsed are added to stats unless it is 0.
+ * Returns the number of files that could not be processed.
+ */
+int strip_files(const std::vector<std::string> &inputs, const std::string &output_directory,
+                StripFunction strip, const char *language, StripCache *cache, bool link,
+                StripStats *stats);
+
+#endif // BATCH_H
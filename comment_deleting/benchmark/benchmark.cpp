@@ -0,0 +1,264 @@
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "async_buffer.h"
+#include "comment_parser.h"
+#include "mapped_file.h"
+
+using std::ifstream;
+using std::ofstream;
+using std::ostream;
+using std::string;
+using std::vector;
+
+/*
+ * Share of each token kind in a generated corpus, the rest is plain code.
+ */
+struct CorpusProfile {
+    string name;
+    double comments;
+    double strings;
+    double continuations;
+};
+
+struct Backend {
+    const char *name;
+    void (*run)(const string &path, ostream &output);
+};
+
+//discards everything, only counts bytes
+class CountingBuffer : public std::streambuf {
+private:
+    long long count_;
+protected:
+    int overflow(int c)
+    {
+        ++count_;
+        return c;
+    }
+    std::streamsize xsputn(const char *, std::streamsize n)
+    {
+        count_ += n;
+        return n;
+    }
+public:
+    CountingBuffer():
+        count_(0)
+    {
+    }
+    long long count() const
+    {
+        return count_;
+    }
+};
+
+static void generate(const string &path, const CorpusProfile &profile, long long size)
+{
+    static const char *code[] = {"int a = b + c;", "x = f(y, z);", "if (p) {", "}", "return q;"};
+    static const char *words[] = {"alpha", "beta", "gamma", "delta", "and", "or"};
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> kind(0, 1);
+    ofstream output(path.c_str(), std::ios::binary);
+    long long written = 0;
+
+    while (written < size) {
+        string token;
+        double k = kind(random);
+        const char *word = words[random() % 6];
+
+        if (k < profile.comments / 2) {
+            token = string("/* ") + word + " " + word + " */";
+        } else if (k < profile.comments) {
+            token = string("// ") + word;
+            if (kind(random) < profile.continuations) {
+                token += "\\\n";
+                token += word;
+            }
+            token += "\n";
+        } else if (k < profile.comments + profile.strings) {
+            token = string("\"") + word + " /* " + word + " */\"";
+        } else {
+            token = code[random() % 5];
+            token += (kind(random) < profile.continuations) ? " \\\n" : "\n";
+        }
+        output << token;
+        written += token.size();
+    }
+}
+
+static void run_plain(const string &path, ostream &output)
+{
+    ifstream input(path.c_str(), std::ios::binary);
+    CommentParser parser;
+
+    parser.delete_comments(input, output);
+}
+
+static void run_async(const string &path, ostream &output)
+{
+    ifstream input(path.c_str(), std::ios::binary);
+    CommentParser parser;
+    AsyncInputBuffer input_buffer(input, CommentParser::BUFFER_CAPACITY);
+    AsyncOutputBuffer output_buffer(output, CommentParser::BUFFER_CAPACITY);
+
+    parser.delete_comments(input_buffer, output_buffer);
+}
+
+static void run_blank(const string &path, ostream &output)
+{
+    MappedFile file(path);
+    CommentParser parser;
+
+    parser.blank_comments(file.data(), file.data() + file.size());
+    output.write(file.data(), file.size());
+}
+
+static long long file_size(const string &path)
+{
+    ifstream input(path.c_str(), std::ios::binary | std::ios::ate);
+
+    return input.tellg();
+}
+
+struct Measurement {
+    double seconds;
+    long long written;
+    long peak_rss_kb;
+};
+
+/*
+ * Run the backend in a forked child, so that the peak RSS from wait4()
+ * belongs to this corpus and backend only, not to the whole process.
+ */
+static bool measure(const Backend &backend, const string &path, Measurement &measurement)
+{
+    int channel[2];
+
+    if (pipe(channel)) {
+        return false;
+    }
+    pid_t child = fork();
+    if (child < 0) {
+        close(channel[0]);
+        close(channel[1]);
+        return false;
+    }
+    if (!child) {
+        CountingBuffer counter;
+        ostream output(&counter);
+        close(channel[0]);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        backend.run(path, output);
+        measurement.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        measurement.written = counter.count();
+        bool sent = write(channel[1], &measurement, sizeof(measurement)) == (ssize_t)sizeof(measurement);
+        _exit(sent ? 0 : 1);
+    }
+
+    close(channel[1]);
+    bool received = read(channel[0], &measurement, sizeof(measurement)) == (ssize_t)sizeof(measurement);
+    close(channel[0]);
+
+    int status;
+    struct rusage usage;
+    if (wait4(child, &status, 0, &usage) != child || !WIFEXITED(status) || WEXITSTATUS(status)) {
+        return false;
+    }
+    measurement.peak_rss_kb = usage.ru_maxrss;
+    return received;
+}
+
+//"name:comments,strings,continuations", shares in [0, 1]
+static bool parse_profile(const char *text, CorpusProfile &profile)
+{
+    const char *colon = strchr(text, ':');
+    if (!colon) {
+        return false;
+    }
+    profile.name = string(text, colon);
+    return sscanf(colon + 1, "%lf,%lf,%lf", &profile.comments, &profile.strings, &profile.continuations) == 3
+        && profile.comments >= 0 && profile.strings >= 0 && profile.comments + profile.strings <= 1
+        && profile.continuations >= 0 && profile.continuations <= 1;
+}
+
+/*
+ * usage: benchmark [--profile name:comments,strings,continuations ...] [size_kb ...]
+ * Without --profile four built-in densities are used. Corpora are written
+ * to the current directory and removed afterwards.
+ */
+int main(int argc, char *argv[])
+{
+    const Backend backends[] = {
+        {"stream", run_plain},
+        {"async", run_async},
+        {"blank", run_blank}
+    };
+    vector<CorpusProfile> profiles;
+    vector<long long> sizes;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--profile") && i + 1 < argc) {
+            CorpusProfile profile;
+            if (!parse_profile(argv[++i], profile)) {
+                fprintf(stderr, "bad profile %s\n", argv[i]);
+                return 1;
+            }
+            profiles.push_back(profile);
+        } else {
+            sizes.push_back(atoll(argv[i]) * 1024);
+        }
+    }
+    if (profiles.empty()) {
+        const CorpusProfile defaults[] = {
+            {"code", 0.0, 0.0, 0.0},
+            {"comments", 0.5, 0.05, 0.0},
+            {"strings", 0.05, 0.5, 0.0},
+            {"continuations", 0.3, 0.05, 0.3}
+        };
+        profiles.assign(defaults, defaults + sizeof(defaults) / sizeof(defaults[0]));
+    }
+    if (sizes.empty()) {
+        sizes.push_back(64 * 1024);
+        sizes.push_back(1024 * 1024);
+        sizes.push_back(16 * 1024 * 1024);
+    }
+
+    printf("%-14s %12s %-8s %10s %14s %12s\n",
+           "corpus", "bytes", "backend", "MB/s", "dropped", "peak_rss_kb");
+    for (size_t s = 0; s < sizes.size(); ++s) {
+        for (size_t p = 0; p < profiles.size(); ++p) {
+            string path = "corpus_" + profiles[p].name + ".c";
+            generate(path, profiles[p], sizes[s]);
+
+            for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]); ++b) {
+                long long size = file_size(path);
+                Measurement measurement;
+
+                if (!measure(backends[b], path, measurement)) {
+                    fprintf(stderr, "%s failed on %s\n", backends[b].name, path.c_str());
+                    continue;
+                }
+                printf("%-14s %12lld %-8s %10.1f %14lld %12ld\n",
+                       profiles[p].name.c_str(), size, backends[b].name,
+                       size / measurement.seconds / (1024 * 1024), size - measurement.written,
+                       measurement.peak_rss_kb);
+            }
+            remove(path.c_str());
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,23 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG += thread
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += -std=c++11
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    benchmark.cpp \
+    ../buffer.cpp \
+    ../async_buffer.cpp \
+    ../mapped_file.cpp \
+    ../stats.cpp
+
+HEADERS += \
+    ../comment_parser.h \
+    ../language_profile.h \
+    ../buffer.h \
+    ../async_buffer.h \
+    ../mapped_file.h \
+    ../stats.h
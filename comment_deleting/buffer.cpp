@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include "buffer.h"
 
 Buffer::Buffer(int capacity):
@@ -15,66 +17,141 @@ Buffer::~Buffer()
 InputBuffer::InputBuffer(std::istream &input, int capacity):
     Buffer(capacity),
     input_(input),
-    size_(0)
+    size_(0),
+    stats_(0)
+{
+    memset(history_, 0, sizeof(history_));
+}
+
+void InputBuffer::set_stats(StripStats *stats)
+{
+    stats_ = stats;
+}
+
+void InputBuffer::underflow()
 {
+    //keep the tail of the consumed buffer for behind()
+    char kept[LOOKBACK];
+    for (int i = 0; i < LOOKBACK; ++i) {
+        kept[i] = (i < size_) ? buf_[size_ - 1 - i] : history_[i - size_];
+    }
+    memcpy(history_, kept, sizeof(history_));
+
+    if (!stats_) {
+        refill();
+        return;
+    }
+
+    StatsClock::time_point start = StatsClock::now();
+    refill();
+    stats_->read_seconds += seconds_since(start);
+    if (size_) {
+        stats_->bytes_read += size_;
+        ++stats_->refills;
+    }
+}
+
+void InputBuffer::refill()
+{
+    input_.read(buf_, capacity_);
+    current_ = 0;
+    size_ = input_.gcount();
 }
 
 char InputBuffer::get()
 {
     if (current_ >= size_) {
-        input_.read(buf_, capacity_);
-        current_ = 0;
-        size_ = input_.gcount();
+        underflow();
     }
-    if (size_) {
+    if (current_ < size_) {
         return buf_[current_++];
     } else {
         return 0;
     }
 }
 
-
 bool InputBuffer::get(char &c)
 {
-    c = get();
-
-    if (c) {
+    if (current_ >= size_) {
+        underflow();
+    }
+    if (current_ < size_) {
+        c = buf_[current_++];
         return true;
     }
-
     return false;
 }
 
 char InputBuffer::peek()
 {
+    if (current_ >= size_) {
+        underflow();
+    }
     if (current_ < size_){
         return buf_[current_];
     }
-    return input_.peek();
+    return 0;
+}
+
+bool InputBuffer::peek(char &c)
+{
+    if (current_ >= size_) {
+        underflow();
+    }
+    if (current_ < size_) {
+        c = buf_[current_];
+        return true;
+    }
+    return false;
 }
 
 OutputBuffer::OutputBuffer(std::ostream &output, int capacity):
     Buffer(capacity),
-    output_(output)
+    output_(output),
+    stats_(0)
 {
 }
 
-void OutputBuffer::put(char c)
+void OutputBuffer::set_stats(StripStats *stats)
 {
-    if (current_ < capacity_) {
-        buf_[current_++] = c;
-    } else {
-        output_.write(buf_, capacity_);
-        current_ = 0;
+    stats_ = stats;
+}
+
+void OutputBuffer::overflow()
+{
+    if (!stats_) {
+        drain();
+        return;
     }
+
+    StatsClock::time_point start = StatsClock::now();
+    if (current_) {
+        stats_->bytes_written += current_;
+        ++stats_->drains;
+    }
+    drain();
+    stats_->write_seconds += seconds_since(start);
 }
 
-void OutputBuffer::flush()
+void OutputBuffer::drain()
 {
     output_.write(buf_, current_);
     current_ = 0;
 }
 
+void OutputBuffer::put(char c)
+{
+    if (current_ >= capacity_) {
+        overflow();
+    }
+    buf_[current_++] = c;
+}
+
+void OutputBuffer::flush()
+{
+    overflow();
+}
+
 OutputBuffer::~OutputBuffer()
 {
     flush();
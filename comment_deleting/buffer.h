@@ -4,6 +4,8 @@
 #include <istream>
 #include <ostream>
 
+#include "stats.h"
+
 class Buffer {
 protected:
     int capacity_;
@@ -11,28 +13,98 @@ protected:
     int current_;
 public:
     Buffer(int capacity);
-    ~Buffer();
+    virtual ~Buffer();
 };
 
 class InputBuffer : public Buffer {
-private:
+public:
+    //how far behind() reaches back
+    static const int LOOKBACK = 16;
+protected:
     std::istream &input_;
     int size_;
+    StripStats *stats_;
+    //the last bytes of the previous buffer, latest first
+    char history_[LOOKBACK];
+
+    //fill buf_ with the next chunk of input, set size_ and current_
+    virtual void refill();
+    void underflow();
 public:
     InputBuffer(std::istream &input, int capacity);
+    void set_stats(StripStats *stats);
+    //get() and peek() return 0 at the end of input, which a NUL byte also reads as
     char get();
+    //false at the end of input, c may be any byte including NUL otherwise
     bool get(char &c);
     char peek();
+    bool peek(char &c);
+    //byte distance positions before the next one, 1 <= distance <= LOOKBACK, 0 before the start
+    char behind(int distance) const
+    {
+        return (distance <= current_) ? buf_[current_ - distance] : history_[distance - current_ - 1];
+    }
 };
 
 class OutputBuffer : public Buffer {
-private:
+protected:
     std::ostream &output_;
+    StripStats *stats_;
+
+    //hand the first current_ bytes of buf_ to the output
+    virtual void drain();
+    void overflow();
 public:
     OutputBuffer(std::ostream &output, int capacity);
+    void set_stats(StripStats *stats);
     ~OutputBuffer();
     void put(char c);
-    void flush();
+    virtual void flush();
+};
+
+//InputBuffer interface over bytes already in memory
+class MemoryInput {
+private:
+    const char *begin_;
+    const char *current_;
+    const char *end_;
+public:
+    MemoryInput(const char *begin, const char *end):
+        begin_(begin),
+        current_(begin),
+        end_(end)
+    {
+    }
+    char get()
+    {
+        return (current_ < end_) ? *current_++ : 0;
+    }
+    bool get(char &c)
+    {
+        if (current_ < end_) {
+            c = *current_++;
+            return true;
+        }
+        return false;
+    }
+    char peek()
+    {
+        return (current_ < end_) ? *current_ : 0;
+    }
+    bool peek(char &c)
+    {
+        if (current_ < end_) {
+            c = *current_;
+            return true;
+        }
+        return false;
+    }
+    static const int LOOKBACK = 16;
+
+    char behind(int distance) const
+    {
+        return (current_ - begin_ >= distance) ? current_[-distance] : 0;
+    }
 };
 
 #endif // BUFFER_H
@@ -1,13 +1,38 @@
 TEMPLATE = app
 CONFIG += console
+CONFIG += thread
 CONFIG -= qt
 
+QMAKE_CXXFLAGS += -std=c++11
+
+LIBS += -lz
+
+CONFIG += link_pkgconfig
+packagesExist(libzstd) {
+    DEFINES += HAVE_ZSTD
+    PKGCONFIG += libzstd
+}
+
 SOURCES += \
     test.cpp \
-    comment_parser.cpp \
-    buffer.cpp
+    buffer.cpp \
+    async_buffer.cpp \
+    hash.cpp \
+    strip_cache.cpp \
+    batch.cpp \
+    mapped_file.cpp \
+    stats.cpp \
+    compressed_buffer.cpp
 
 HEADERS += \
     comment_parser.h \
-    buffer.h
-
+    language_profile.h \
+    buffer.h \
+    async_buffer.h \
+    hash.h \
+    strip_cache.h \
+    batch.h \
+    mapped_file.h \
+    stats.h \
+    compressed_buffer.h \
+    comment_parser_test.h
@@ -2,24 +2,456 @@
 #define COMMENT_PARSER_H
 #include <iostream>
 #include <stack>
+#include <string>
+#include <vector>
 
 #include "buffer.h"
+#include "language_profile.h"
+#include "stats.h"
 
 using std::istream;
 using std::ostream;
 using std::stack;
+using std::string;
+using std::vector;
 
-class CommentParser
+//language independent part of BasicCommentParser
+class CommentParserBase
+{
+public:
+    //what a source byte belongs to
+    enum Kind {
+        CODE,
+        LINE_COMMENT,
+        BLOCK_COMMENT,
+        STRING
+    };
+
+    //bytes [offset, offset + length) of the scanned buffer are of this kind
+    struct Span {
+        size_t offset;
+        size_t length;
+        Kind kind;
+    };
+
+    static const int BUFFER_CAPACITY = 1 << 16;
+
+protected:
+    //writes code and strings, drops comments
+    struct StripSink {
+        OutputBuffer &output;
+
+        StripSink(OutputBuffer &buffer): output(buffer) {}
+        void open(Kind) {}
+        void put(Kind kind, char c)
+        {
+            if (kind == CODE || kind == STRING) {
+                output.put(c);
+            }
+        }
+    };
+
+    //overwrites comment bytes with spaces where they lie, keeps newlines
+    struct BlankSink {
+        char *position;
+
+        BlankSink(char *begin): position(begin) {}
+        void open(Kind) {}
+        void put(Kind kind, char)
+        {
+            if ((kind == LINE_COMMENT || kind == BLOCK_COMMENT) && *position != '\n') {
+                *position = ' ';
+            }
+            ++position;
+        }
+    };
+
+    //extends the last span while the kind stays the same
+    struct SpanSink {
+        vector<Span> &spans;
+        size_t position;
+        bool split;
+
+        SpanSink(vector<Span> &output): spans(output), position(0), split(true) {}
+        void open(Kind)
+        {
+            split = true;
+        }
+        void put(Kind kind, char)
+        {
+            if (split || spans.back().kind != kind) {
+                Span span = {position, 0, kind};
+                spans.push_back(span);
+                split = false;
+            }
+            ++spans.back().length;
+            ++position;
+        }
+    };
+};
+
+/*
+ * Comment stripper for the syntax described by Profile (see language_profile.h).
+ * All markers are compile-time constants, so each language gets its own scanner.
+ */
+template <class Profile>
+class BasicCommentParser : public CommentParserBase
 {
 private:
-    void skip_new_line(InputBuffer &input);
-    void skip_line_comment(InputBuffer &input);
-    void skip_multiline_comment(InputBuffer &input);
-    void parse_string(InputBuffer &buffer, OutputBuffer &output);
+    //bytes consumed while matching a marker but not yet classified
+    string pending_;
+    //previous byte outside comments, for word_start_comments()
+    char last_;
+    StripStats *stats_;
+
+    /*
+     * Feeds every byte of input to sink.put(kind, byte) exactly once, in order.
+     * sink.open(kind) is called before the first byte of each comment and string.
+     */
+    template <class Reader, class Sink> void scan(Reader &input, Sink &sink);
+    template <class Reader> void skip_new_line(Reader &input);
+    template <class Reader> int match(Reader &input, const char *marker, int from, int length);
+    template <class Sink> void put_pending(Sink &sink, Kind kind);
+    template <class Reader> Kind classify(Reader &input, char current);
+    template <class Reader, class Sink> void skip_line_comment(Reader &input, Sink &sink);
+    template <class Reader, class Sink> void skip_multiline_comment(Reader &input, Sink &sink);
+    template <class Reader, class Sink> void parse_string(Reader &input, Sink &sink, char quote);
+    bool at_word_start() const;
+    template <class Reader> static bool in_number(const Reader &input);
 
 public:
+    BasicCommentParser();
+    //collect counters into stats (also passed on to the buffers), 0 to stop
+    void set_stats(StripStats *stats);
     void delete_comments(istream &input, ostream &output);
-
+    void delete_comments(InputBuffer &input, OutputBuffer &output);
+    //replace comments in [begin, end) with spaces, keeping newlines and offsets
+    void blank_comments(char *begin, char *end);
+    //append spans covering [begin, end) to spans, without copying any bytes
+    void tokenize(const char *begin, const char *end, vector<Span> &spans);
 };
 
+typedef BasicCommentParser<CLanguage> CommentParser;
+
+//strip_files compatible entry point, stats may be 0
+template <class Profile> void strip_comments(istream &input, ostream &output, StripStats *stats)
+{
+    BasicCommentParser<Profile> parser;
+
+    parser.set_stats(stats);
+    parser.delete_comments(input, output);
+}
+
+template <class Profile>
+BasicCommentParser<Profile>::BasicCommentParser():
+    last_(0),
+    stats_(0)
+{
+}
+
+template <class Profile>
+void BasicCommentParser<Profile>::set_stats(StripStats *stats)
+{
+    stats_ = stats;
+}
+
+template <class Profile>
+void BasicCommentParser<Profile>::delete_comments(istream &input, ostream &output)
+{
+    InputBuffer input_buffer(input, BUFFER_CAPACITY);
+    OutputBuffer output_buffer(output, BUFFER_CAPACITY);
+
+    delete_comments(input_buffer, output_buffer);
+}
+
+template <class Profile>
+void BasicCommentParser<Profile>::delete_comments(InputBuffer &input, OutputBuffer &output)
+{
+    StripSink sink(output);
+
+    if (!stats_) {
+        scan(input, sink);
+        output.flush();
+        return;
+    }
+
+    input.set_stats(stats_);
+    output.set_stats(stats_);
+    double waited = stats_->read_seconds + stats_->write_seconds;
+    StatsClock::time_point start = StatsClock::now();
+    scan(input, sink);
+    output.flush();
+    waited = stats_->read_seconds + stats_->write_seconds - waited;
+    stats_->lex_seconds += seconds_since(start) - waited;
+}
+
+template <class Profile>
+void BasicCommentParser<Profile>::blank_comments(char *begin, char *end)
+{
+    MemoryInput input(begin, end);
+    BlankSink sink(begin);
+    StatsClock::time_point start = StatsClock::now();
+
+    scan(input, sink);
+    if (stats_) {
+        stats_->bytes_read += end - begin;
+        stats_->lex_seconds += seconds_since(start);
+    }
+}
+
+template <class Profile>
+void BasicCommentParser<Profile>::tokenize(const char *begin, const char *end, vector<Span> &spans)
+{
+    MemoryInput input(begin, end);
+    SpanSink sink(spans);
+    StatsClock::time_point start = StatsClock::now();
+
+    scan(input, sink);
+    if (stats_) {
+        stats_->bytes_read += end - begin;
+        stats_->lex_seconds += seconds_since(start);
+    }
+}
+
+template <class Profile>
+template <class Reader, class Sink>
+void BasicCommentParser<Profile>::scan(Reader &input, Sink &sink)
+{
+    char current;
+
+    last_ = 0;
+    while (input.get(current)) {
+        if (contains(Profile::quotes(), current)
+                && !(Profile::digit_separators() && current == '\'' && in_number(input))) {
+            if (stats_) {
+                ++stats_->strings;
+            }
+            sink.open(STRING);
+            sink.put(STRING, current);
+            parse_string(input, sink, current);
+            last_ = current;
+            continue;
+        }
+
+        Kind kind = classify(input, current);
+        if (kind == CODE) {
+            sink.put(CODE, current);
+            put_pending(sink, CODE);
+            if (Profile::word_start_comments()) {
+                last_ = current;
+            }
+            continue;
+        }
+
+        if (stats_) {
+            ++(kind == BLOCK_COMMENT ? stats_->block_comments : stats_->line_comments);
+        }
+        sink.open(kind);
+        sink.put(kind, current);
+        put_pending(sink, kind);
+        if (kind == BLOCK_COMMENT) {
+            skip_multiline_comment(input, sink);
+            last_ = ' ';
+        } else {
+            skip_line_comment(input, sink);
+        }
+    }
+}
+
+/*
+ * Decide whether current starts a comment. Marker bytes read after it
+ * are left in pending_ with the kind returned.
+ */
+template <class Profile>
+template <class Reader>
+typename BasicCommentParser<Profile>::Kind BasicCommentParser<Profile>::classify(Reader &input, char current)
+{
+    const int line_length = marker_length(Profile::line_comment());
+    const int block_length = marker_length(Profile::block_begin());
+    const int shared = common_prefix(Profile::line_comment(), Profile::block_begin());
+
+    if (Profile::word_start_comments() && !at_word_start()) {
+        return CODE;
+    }
+
+    if (block_length && current == Profile::block_begin()[0]) {
+        int matched = match(input, Profile::block_begin(), 1, block_length);
+        if (matched == block_length) {
+            return BLOCK_COMMENT;
+        }
+        //the line marker may share a prefix with the block one: "//" and "/*", "--" and "--[["
+        if (line_length && shared >= line_length && matched >= line_length) {
+            return LINE_COMMENT;
+        }
+        if (line_length && shared >= matched && matched < line_length
+                && match(input, Profile::line_comment(), matched, line_length) == line_length) {
+            return LINE_COMMENT;
+        }
+        return CODE;
+    }
+
+    if (line_length && current == Profile::line_comment()[0]
+            && match(input, Profile::line_comment(), 1, line_length) == line_length) {
+        return LINE_COMMENT;
+    }
+    return CODE;
+}
+
+template <class Profile>
+bool BasicCommentParser<Profile>::at_word_start() const
+{
+    return !last_ || last_ == ' ' || last_ == '\t' || last_ == '\n' || last_ == '\r'
+            || last_ == ';' || last_ == '|' || last_ == '&' || last_ == '(' || last_ == ')';
+}
+
+/*
+ * For digit_separators(): whether the quote just read is inside a number.
+ * Looks back over the word bytes, '.' and separators before it, only when
+ * a quote is seen, so the scan does no per byte work for it. The run has
+ * to start with a digit, so L'x', u8'x' and case'x' stay literals; a run
+ * longer than the lookback is a number if it is all hex digits.
+ */
+template <class Profile>
+template <class Reader>
+bool BasicCommentParser<Profile>::in_number(const Reader &input)
+{
+    bool hex = true;
+
+    for (int distance = 2; distance <= Reader::LOOKBACK; ++distance) {
+        unsigned char c = input.behind(distance);
+        if (c == '\'') {
+            //an earlier separator of the same number
+            return true;
+        }
+        if (!is_word(c) && c != '.') {
+            return distance > 2 && is_digit(input.behind(distance - 1));
+        }
+        hex = hex && is_hex(c);
+    }
+    return hex;
+}
+
+//consume marker[from, length) into pending_, return the length actually matched
+template <class Profile>
+template <class Reader>
+int BasicCommentParser<Profile>::match(Reader &input, const char *marker, int from, int length)
+{
+    for (int i = from; i < length; ++i) {
+        skip_new_line(input);
+        if (input.peek() != marker[i]) {
+            return i;
+        }
+        pending_ += input.get();
+    }
+
+    return length;
+}
+
+template <class Profile>
+template <class Reader>
+void BasicCommentParser<Profile>::skip_new_line(Reader &input)
+{
+    char current;
+
+    if (!Profile::line_splicing()) {
+        return;
+    }
+    while (input.peek() == '\\') {
+        //get '\'
+        pending_ += input.get();
+        //get '\n'
+        if (input.get(current)) {
+            pending_ += current;
+        }
+    }
+}
+
+template <class Profile>
+template <class Sink>
+void BasicCommentParser<Profile>::put_pending(Sink &sink, Kind kind)
+{
+    for (size_t i = 0; i < pending_.size(); ++i) {
+        sink.put(kind, pending_[i]);
+    }
+    pending_.clear();
+}
+
+template <class Profile>
+template <class Reader, class Sink>
+void BasicCommentParser<Profile>::skip_line_comment(Reader &input, Sink &sink)
+{
+    char next;
+
+    while (input.peek(next) && next != '\n') {
+        if (Profile::line_splicing() && next == '\\') {
+            skip_new_line(input);
+            put_pending(sink, LINE_COMMENT);
+        } else {
+            sink.put(LINE_COMMENT, input.get());
+        }
+    }
+}
+
+template <class Profile>
+template <class Reader, class Sink>
+void BasicCommentParser<Profile>::skip_multiline_comment(Reader &input, Sink &sink)
+{
+    const int end_length = marker_length(Profile::block_end());
+    char current;
+
+    while (input.get(current)) {
+        sink.put(BLOCK_COMMENT, current);
+        if (current == Profile::block_end()[0]) {
+            int matched = 1;
+            for (; matched < end_length; ++matched) {
+                skip_new_line(input);
+                put_pending(sink, BLOCK_COMMENT);
+                if (input.peek() != Profile::block_end()[matched]) {
+                    break;
+                }
+                sink.put(BLOCK_COMMENT, input.get());
+            }
+            if (matched == end_length) {
+                return;
+            }
+        }
+    }
+}
+
+template <class Profile>
+template <class Reader, class Sink>
+void BasicCommentParser<Profile>::parse_string(Reader &input, Sink &sink, char quote)
+{
+    const bool escapes = Profile::escape() && !contains(Profile::raw_quotes(), quote);
+    bool triple = false;
+    int closing = 0;
+    char current;
+
+    if (Profile::triple_quotes() && input.peek() == quote) {
+        sink.put(STRING, input.get());
+        if (input.peek() != quote) {
+            //empty string
+            return;
+        }
+        sink.put(STRING, input.get());
+        triple = true;
+    }
+
+    while (input.get(current)) {
+        sink.put(STRING, current);
+        if (escapes && current == Profile::escape()) {
+            if (input.get(current)) {
+                sink.put(STRING, current);
+            }
+            closing = 0;
+        } else if (current == quote) {
+            if (!triple || ++closing == 3) {
+                return;
+            }
+        } else {
+            closing = 0;
+        }
+    }
+}
+
 #endif // COMMENT_PARSER_H
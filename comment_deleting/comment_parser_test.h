@@ -0,0 +1,137 @@
+#ifndef COMMENT_PARSER_TEST_H
+#define COMMENT_PARSER_TEST_H
+
+#include <cassert>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "comment_parser.h"
+#include "compressed_buffer.h"
+
+//strip source into compression, then decompress and strip again
+inline std::string compress_stripped(const std::string &source, Compression compression)
+{
+    std::istringstream input(source);
+    std::ostringstream compressed;
+    CommentParser parser;
+    InputBuffer input_buffer(input, 64);
+    CompressingOutputBuffer output_buffer(compressed, 64, compression);
+
+    parser.delete_comments(input_buffer, output_buffer);
+    output_buffer.finish();
+    return compressed.str();
+}
+
+inline std::string decompress_stripped(const std::string &compressed)
+{
+    std::istringstream input(compressed);
+    std::ostringstream output;
+    CommentParser parser;
+    DecompressingInputBuffer input_buffer(input, 64);
+    {
+        OutputBuffer output_buffer(output, 64);
+        parser.delete_comments(input_buffer, output_buffer);
+    }
+    return output.str();
+}
+
+void compressed_round_trip_test()
+{
+    std::string source;
+    std::string expected;
+    for (int i = 0; i < 1000; ++i) {
+        source += "int a = 1; // comment\nchar *s = \"/* kept */\"; /* block */\n";
+        expected += "int a = 1; \nchar *s = \"/* kept */\"; \n";
+    }
+
+    std::string compressed = compress_stripped(source, GZIP);
+    assert(compressed.size() > 2 && compressed[0] == '\x1f');
+    assert(decompress_stripped(compressed) == expected);
+    //concatenated members
+    assert(decompress_stripped(compressed + compressed) == expected + expected);
+}
+
+void truncated_input_test()
+{
+    std::string compressed = compress_stripped("int a; // comment\nint b;\n", GZIP);
+    bool thrown = false;
+
+    try {
+        decompress_stripped(compressed.substr(0, compressed.size() - 5));
+    } catch (const std::runtime_error &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+inline std::string strip(const std::string &source)
+{
+    std::istringstream input(source);
+    std::ostringstream output;
+
+    strip_comments<CLanguage>(input, output, 0);
+    return output.str();
+}
+
+void digit_separator_test()
+{
+    assert(strip("int a = 1'000'000; // c\n") == "int a = 1'000'000; \n");
+    assert(strip("x = 0x1234abcd'ef01; // c\n") == "x = 0x1234abcd'ef01; \n");
+    assert(strip("d = 1.5'0; /* c */\n") == "d = 1.5'0; \n");
+    //encoding prefixes and keywords still open character literals
+    assert(strip("w = L'/'; // c\n") == "w = L'/'; \n");
+    assert(strip("u = u8'/'; // c\n") == "u = u8'/'; \n");
+    assert(strip("case'/': // c\n") == "case'/': \n");
+    assert(strip("f(1, '/'); // c\n") == "f(1, '/'); \n");
+
+    //the look back crosses buffer refills
+    std::istringstream input("n = 12'345'678; // c\nw = L'/'; // d\n");
+    std::ostringstream output;
+    CommentParser parser;
+    InputBuffer input_buffer(input, 3);
+    {
+        OutputBuffer output_buffer(output, 3);
+        parser.delete_comments(input_buffer, output_buffer);
+    }
+    assert(output.str() == "n = 12'345'678; \nw = L'/'; \n");
+}
+
+//a NUL byte is data, scanning ends at the end of the range
+void embedded_nul_test()
+{
+    const char source[] = "int a; /* x */\0 int b; // c\n\0// d\n";
+    const char stripped[] = "int a; \0 int b; \n\0\n";
+    const char blank[] = "int a;        \0 int b;     \n\0    \n";
+    const size_t size = sizeof(source) - 1;
+    CommentParser parser;
+
+    assert(strip(std::string(source, size)) == std::string(stripped, sizeof(stripped) - 1));
+
+    std::string blanked(source, size);
+    parser.blank_comments(&blanked[0], &blanked[0] + size);
+    assert(blanked == std::string(blank, sizeof(blank) - 1));
+
+    std::vector<CommentParser::Span> spans;
+    parser.tokenize(source, source + size, spans);
+    size_t covered = 0;
+    int comments = 0;
+    for (size_t i = 0; i < spans.size(); ++i) {
+        assert(spans[i].offset == covered);
+        covered += spans[i].length;
+        comments += spans[i].kind != CommentParser::CODE;
+    }
+    assert(covered == size);
+    assert(comments == 3);
+}
+
+void test()
+{
+    digit_separator_test();
+    embedded_nul_test();
+    compressed_round_trip_test();
+    truncated_input_test();
+}
+
+#endif // COMMENT_PARSER_TEST_H
@@ -0,0 +1,240 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "compressed_buffer.h"
+
+using std::runtime_error;
+
+DecompressingInputBuffer::DecompressingInputBuffer(std::istream &input, int capacity):
+    InputBuffer(input, capacity),
+    in_size_(0),
+    in_position_(0),
+    compression_(NO_COMPRESSION),
+    detected_(false),
+    drained_(true),
+    complete_(false)
+{
+    in_ = new char[capacity_];
+    memset(&zlib_, 0, sizeof(zlib_));
+#ifdef HAVE_ZSTD
+    zstd_ = 0;
+#endif
+}
+
+DecompressingInputBuffer::~DecompressingInputBuffer()
+{
+    if (compression_ == GZIP) {
+        inflateEnd(&zlib_);
+    }
+#ifdef HAVE_ZSTD
+    if (zstd_) {
+        ZSTD_freeDStream(zstd_);
+    }
+#endif
+    delete []in_;
+}
+
+bool DecompressingInputBuffer::read_input()
+{
+    input_.read(in_, capacity_);
+    in_size_ = input_.gcount();
+    in_position_ = 0;
+
+    return in_size_ > 0;
+}
+
+void DecompressingInputBuffer::detect()
+{
+    const unsigned char *magic = reinterpret_cast<const unsigned char *>(in_);
+
+    detected_ = true;
+    read_input();
+    if (in_size_ >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+        compression_ = GZIP;
+    } else if (in_size_ >= 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+#ifdef HAVE_ZSTD
+        compression_ = ZSTD;
+        zstd_ = ZSTD_createDStream();
+        ZSTD_initDStream(zstd_);
+        return;
+#else
+        throw runtime_error("zstd input, but built without HAVE_ZSTD");
+#endif
+    }
+
+    if (compression_ == GZIP && inflateInit2(&zlib_, 15 + 32) != Z_OK) {
+        throw runtime_error("cannot initialize zlib");
+    }
+}
+
+//decode the available input into buf_, return the number of bytes produced
+int DecompressingInputBuffer::decode()
+{
+#ifdef HAVE_ZSTD
+    if (compression_ == ZSTD) {
+        ZSTD_inBuffer in = {in_, (size_t)in_size_, (size_t)in_position_};
+        ZSTD_outBuffer out = {buf_, (size_t)capacity_, 0};
+
+        size_t result = ZSTD_decompressStream(zstd_, &out, &in);
+        if (ZSTD_isError(result)) {
+            throw runtime_error(ZSTD_getErrorName(result));
+        }
+        //0 once a frame is decoded and flushed
+        complete_ = !result;
+        in_position_ = in.pos;
+        return out.pos;
+    }
+#endif
+
+    zlib_.next_in = reinterpret_cast<Bytef *>(in_ + in_position_);
+    zlib_.avail_in = in_size_ - in_position_;
+    zlib_.next_out = reinterpret_cast<Bytef *>(buf_);
+    zlib_.avail_out = capacity_;
+
+    int result = inflate(&zlib_, Z_NO_FLUSH);
+    if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+        throw runtime_error("corrupted gzip input");
+    }
+    in_position_ = in_size_ - zlib_.avail_in;
+    if (result != Z_BUF_ERROR) {
+        complete_ = result == Z_STREAM_END;
+    }
+    if (result == Z_STREAM_END) {
+        //concatenated gzip members
+        inflateReset(&zlib_);
+    }
+    return capacity_ - zlib_.avail_out;
+}
+
+void DecompressingInputBuffer::refill()
+{
+    current_ = 0;
+    size_ = 0;
+
+    if (!detected_) {
+        detect();
+    }
+
+    if (compression_ == NO_COMPRESSION) {
+        if (in_position_ < in_size_) {
+            //hand over what detect() has read
+            size_ = in_size_ - in_position_;
+            memcpy(buf_, in_ + in_position_, size_);
+            in_position_ = in_size_;
+        } else {
+            InputBuffer::refill();
+        }
+        return;
+    }
+
+    while (!size_) {
+        if (in_position_ == in_size_ && drained_ && !read_input()) {
+            if (!complete_) {
+                throw runtime_error("truncated input");
+            }
+            return;
+        }
+        size_ = decode();
+        drained_ = size_ < capacity_;
+    }
+}
+
+CompressingOutputBuffer::CompressingOutputBuffer(std::ostream &output, int capacity, Compression compression):
+    OutputBuffer(output, capacity),
+    compression_(compression),
+    finished_(false)
+{
+    out_ = new char[capacity_];
+    memset(&zlib_, 0, sizeof(zlib_));
+#ifdef HAVE_ZSTD
+    zstd_ = 0;
+    if (compression_ == ZSTD) {
+        zstd_ = ZSTD_createCStream();
+        ZSTD_CCtx_setParameter(zstd_, ZSTD_c_compressionLevel, 3);
+        return;
+    }
+#else
+    if (compression_ == ZSTD) {
+        delete []out_;
+        throw runtime_error("zstd output, but built without HAVE_ZSTD");
+    }
+#endif
+    if (compression_ == GZIP && deflateInit2(&zlib_, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                                             15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        delete []out_;
+        throw runtime_error("cannot initialize zlib");
+    }
+}
+
+CompressingOutputBuffer::~CompressingOutputBuffer()
+{
+    if (!finished_) {
+        try {
+            finish();
+        } catch (const std::exception &) {
+        }
+    }
+    current_ = 0;
+    if (compression_ == GZIP) {
+        deflateEnd(&zlib_);
+    }
+#ifdef HAVE_ZSTD
+    if (zstd_) {
+        ZSTD_freeCStream(zstd_);
+    }
+#endif
+    delete []out_;
+}
+
+//compress what is buffered and end the stream
+void CompressingOutputBuffer::finish()
+{
+    finished_ = true;
+    encode(true);
+    current_ = 0;
+    output_.flush();
+    if (!output_) {
+        throw runtime_error("cannot write compressed output");
+    }
+}
+
+void CompressingOutputBuffer::drain()
+{
+    encode(false);
+    current_ = 0;
+}
+
+//compress buf_[0, current_) and write whatever the encoder emits
+void CompressingOutputBuffer::encode(bool finish)
+{
+    if (compression_ == NO_COMPRESSION) {
+        OutputBuffer::drain();
+        return;
+    }
+
+#ifdef HAVE_ZSTD
+    if (compression_ == ZSTD) {
+        ZSTD_inBuffer in = {buf_, (size_t)current_, 0};
+        size_t remaining;
+
+        do {
+            ZSTD_outBuffer out = {out_, (size_t)capacity_, 0};
+            remaining = ZSTD_compressStream2(zstd_, &out, &in, finish ? ZSTD_e_end : ZSTD_e_continue);
+            if (ZSTD_isError(remaining)) {
+                throw runtime_error(ZSTD_getErrorName(remaining));
+            }
+            output_.write(out_, out.pos);
+        } while (finish ? remaining != 0 : in.pos < in.size);
+        return;
+    }
+#endif
+
+    zlib_.next_in = reinterpret_cast<Bytef *>(buf_);
+    zlib_.avail_in = current_;
+    do {
+        zlib_.next_out = reinterpret_cast<Bytef *>(out_);
+        zlib_.avail_out = capacity_;
+        deflate(&zlib_, finish ? Z_FINISH : Z_NO_FLUSH);
+        output_.write(out_, capacity_ - zlib_.avail_out);
+    } while (zlib_.avail_out == 0);
+}
@@ -0,0 +1,78 @@
+#ifndef COMPRESSED_BUFFER_H
+#define COMPRESSED_BUFFER_H
+
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "buffer.h"
+
+enum Compression {
+    NO_COMPRESSION,
+    GZIP,
+    ZSTD
+};
+
+/*
+ * Decompresses straight into the parser's buffer. The format is detected
+ * from the first bytes: gzip, zstd (built with HAVE_ZSTD) or plain text,
+ * which is passed through. Raw zlib is not detected, its two byte header
+ * also matches ordinary text such as "x^".
+ */
+class DecompressingInputBuffer : public InputBuffer {
+private:
+    char *in_;
+    int in_size_;
+    int in_position_;
+    Compression compression_;
+    bool detected_;
+    //the decoder has no more output for the input it was given
+    bool drained_;
+    //the last gzip member or zstd frame is complete, input may end here
+    bool complete_;
+    z_stream zlib_;
+#ifdef HAVE_ZSTD
+    ZSTD_DStream *zstd_;
+#endif
+
+    bool read_input();
+    void detect();
+    int decode();
+
+    DecompressingInputBuffer(const DecompressingInputBuffer &);
+    DecompressingInputBuffer &operator =(const DecompressingInputBuffer &);
+protected:
+    void refill();
+public:
+    DecompressingInputBuffer(std::istream &input, int capacity);
+    ~DecompressingInputBuffer();
+};
+
+/*
+ * Compresses every drained block. finish() writes the end of the stream and
+ * reports errors; the destructor finishes an unfinished stream silently.
+ */
+class CompressingOutputBuffer : public OutputBuffer {
+private:
+    char *out_;
+    Compression compression_;
+    bool finished_;
+    z_stream zlib_;
+#ifdef HAVE_ZSTD
+    ZSTD_CStream *zstd_;
+#endif
+
+    void encode(bool finish);
+
+    CompressingOutputBuffer(const CompressingOutputBuffer &);
+    CompressingOutputBuffer &operator =(const CompressingOutputBuffer &);
+protected:
+    void drain();
+public:
+    CompressingOutputBuffer(std::ostream &output, int capacity, Compression compression);
+    ~CompressingOutputBuffer();
+    void finish();
+};
+
+#endif // COMPRESSED_BUFFER_H
@@ -0,0 +1,102 @@
+#include <cstring>
+
+#include "hash.h"
+
+/*
+ * XXH64, see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+ */
+
+static const uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const unsigned char *p)
+{
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint32_t read32(const unsigned char *p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t accumulate(uint64_t accumulator, uint64_t input)
+{
+    accumulator += input * PRIME2;
+    accumulator = rotl(accumulator, 31);
+    return accumulator * PRIME1;
+}
+
+static inline uint64_t merge_round(uint64_t accumulator, uint64_t value)
+{
+    accumulator ^= accumulate(0, value);
+    return accumulator * PRIME1 + PRIME4;
+}
+
+uint64_t xxhash64(const void *data, size_t length, uint64_t seed)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    const unsigned char *end = p + length;
+    uint64_t hash;
+
+    if (length >= 32) {
+        const unsigned char *limit = end - 32;
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+
+        do {
+            v1 = accumulate(v1, read64(p));
+            v2 = accumulate(v2, read64(p + 8));
+            v3 = accumulate(v3, read64(p + 16));
+            v4 = accumulate(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        hash = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        hash = merge_round(hash, v1);
+        hash = merge_round(hash, v2);
+        hash = merge_round(hash, v3);
+        hash = merge_round(hash, v4);
+    } else {
+        hash = seed + PRIME5;
+    }
+
+    hash += length;
+
+    while (p + 8 <= end) {
+        hash ^= accumulate(0, read64(p));
+        hash = rotl(hash, 27) * PRIME1 + PRIME4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        hash ^= read32(p) * PRIME1;
+        hash = rotl(hash, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    while (p < end) {
+        hash ^= (*p) * PRIME5;
+        hash = rotl(hash, 11) * PRIME1;
+        ++p;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
@@ -0,0 +1,10 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+//XXH64 of [data, data + length)
+uint64_t xxhash64(const void *data, size_t length, uint64_t seed = 0);
+
+#endif // HASH_H
@@ -0,0 +1,124 @@
+#ifndef LANGUAGE_PROFILE_H
+#define LANGUAGE_PROFILE_H
+
+/*
+ * Compile-time descriptions of comment and string syntax for
+ * BasicCommentParser. Every profile provides:
+ *   name()                  - language name, also salts the strip cache
+ *   line_comment()          - marker running to the end of line, "" if none
+ *   block_begin()           - opening marker of a block comment, "" if none
+ *   block_end()             - closing marker of a block comment
+ *   quotes()                - characters opening and closing a string
+ *   raw_quotes()            - quotes in which escape() has no effect
+ *   escape()                - character escaping the next one in strings, 0 if none
+ *   line_splicing()         - backslash-newline joins lines anywhere (C preprocessor)
+ *   triple_quotes()         - three quotes open a string closed by three quotes
+ *   word_start_comments()   - line comment starts only at the beginning of a word
+ *   digit_separators()      - a quote inside a number, 1'000'000, does not open a string
+ * Markers are matched greedily; a line marker may be a prefix of block_begin().
+ */
+
+struct CLanguage {
+    static constexpr const char *name() { return "c"; }
+    static constexpr const char *line_comment() { return "//"; }
+    static constexpr const char *block_begin() { return "/*"; }
+    static constexpr const char *block_end() { return "*/"; }
+    static constexpr const char *quotes() { return "\"'"; }
+    static constexpr const char *raw_quotes() { return ""; }
+    static constexpr char escape() { return '\\'; }
+    static constexpr bool line_splicing() { return true; }
+    static constexpr bool triple_quotes() { return false; }
+    static constexpr bool word_start_comments() { return false; }
+    static constexpr bool digit_separators() { return true; }
+};
+
+struct ShellLanguage {
+    static constexpr const char *name() { return "shell"; }
+    static constexpr const char *line_comment() { return "#"; }
+    static constexpr const char *block_begin() { return ""; }
+    static constexpr const char *block_end() { return ""; }
+    static constexpr const char *quotes() { return "\"'"; }
+    static constexpr const char *raw_quotes() { return "'"; }
+    static constexpr char escape() { return '\\'; }
+    static constexpr bool line_splicing() { return false; }
+    static constexpr bool triple_quotes() { return false; }
+    static constexpr bool word_start_comments() { return true; }
+    static constexpr bool digit_separators() { return false; }
+};
+
+struct PythonLanguage {
+    static constexpr const char *name() { return "python"; }
+    static constexpr const char *line_comment() { return "#"; }
+    static constexpr const char *block_begin() { return ""; }
+    static constexpr const char *block_end() { return ""; }
+    static constexpr const char *quotes() { return "\"'"; }
+    static constexpr const char *raw_quotes() { return ""; }
+    static constexpr char escape() { return '\\'; }
+    static constexpr bool line_splicing() { return false; }
+    static constexpr bool triple_quotes() { return true; }
+    static constexpr bool word_start_comments() { return false; }
+    static constexpr bool digit_separators() { return false; }
+};
+
+//quotes inside SQL strings are doubled, which scans as two adjacent strings
+struct SqlLanguage {
+    static constexpr const char *name() { return "sql"; }
+    static constexpr const char *line_comment() { return "--"; }
+    static constexpr const char *block_begin() { return "/*"; }
+    static constexpr const char *block_end() { return "*/"; }
+    static constexpr const char *quotes() { return "'\""; }
+    static constexpr const char *raw_quotes() { return "'\""; }
+    static constexpr char escape() { return 0; }
+    static constexpr bool line_splicing() { return false; }
+    static constexpr bool triple_quotes() { return false; }
+    static constexpr bool word_start_comments() { return false; }
+    static constexpr bool digit_separators() { return false; }
+};
+
+struct LuaLanguage {
+    static constexpr const char *name() { return "lua"; }
+    static constexpr const char *line_comment() { return "--"; }
+    static constexpr const char *block_begin() { return "--[["; }
+    static constexpr const char *block_end() { return "]]"; }
+    static constexpr const char *quotes() { return "\"'"; }
+    static constexpr const char *raw_quotes() { return ""; }
+    static constexpr char escape() { return '\\'; }
+    static constexpr bool line_splicing() { return false; }
+    static constexpr bool triple_quotes() { return false; }
+    static constexpr bool word_start_comments() { return false; }
+    static constexpr bool digit_separators() { return false; }
+};
+
+//length of a marker
+constexpr int marker_length(const char *marker)
+{
+    return *marker ? 1 + marker_length(marker + 1) : 0;
+}
+
+//length of the common prefix of two markers
+constexpr int common_prefix(const char *first, const char *second)
+{
+    return (*first && *first == *second) ? 1 + common_prefix(first + 1, second + 1) : 0;
+}
+
+constexpr bool contains(const char *characters, char c)
+{
+    return *characters && (*characters == c || contains(characters + 1, c));
+}
+
+constexpr bool is_digit(unsigned char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+constexpr bool is_word(unsigned char c)
+{
+    return is_digit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+constexpr bool is_hex(unsigned char c)
+{
+    return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F') || c == 'x' || c == 'X';
+}
+
+#endif // LANGUAGE_PROFILE_H
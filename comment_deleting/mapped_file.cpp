@@ -0,0 +1,56 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+#include "mapped_file.h"
+
+using std::runtime_error;
+using std::string;
+
+MappedFile::MappedFile(const string &path):
+    data_(0),
+    size_(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("cannot open " + path);
+    }
+
+    struct stat status;
+    if (fstat(fd, &status)) {
+        close(fd);
+        throw runtime_error("cannot stat " + path);
+    }
+    size_ = status.st_size;
+
+    if (size_) {
+        void *memory = mmap(0, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (memory == MAP_FAILED) {
+            close(fd);
+            throw runtime_error("cannot map " + path);
+        }
+        data_ = static_cast<char *>(memory);
+        madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_) {
+        munmap(data_, size_);
+    }
+}
+
+char *MappedFile::data()
+{
+    return data_;
+}
+
+size_t MappedFile::size() const
+{
+    return size_;
+}
@@ -0,0 +1,25 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/*
+ * Private writable mapping of a whole file: writes go to copy-on-write
+ * pages and never reach the file itself.
+ */
+class MappedFile {
+private:
+    char *data_;
+    size_t size_;
+
+    MappedFile(const MappedFile &);
+    MappedFile &operator =(const MappedFile &);
+public:
+    MappedFile(const std::string &path);
+    ~MappedFile();
+    char *data();
+    size_t size() const;
+};
+
+#endif // MAPPED_FILE_H
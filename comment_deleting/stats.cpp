@@ -0,0 +1,35 @@
+#include "stats.h"
+
+StripStats::StripStats():
+    bytes_read(0),
+    bytes_written(0),
+    refills(0),
+    drains(0),
+    read_seconds(0),
+    write_seconds(0),
+    lex_seconds(0),
+    line_comments(0),
+    block_comments(0),
+    strings(0)
+{
+}
+
+double seconds_since(StatsClock::time_point start)
+{
+    return std::chrono::duration<double>(StatsClock::now() - start).count();
+}
+
+void write_json(std::ostream &output, const StripStats &stats)
+{
+    output << "{\"bytes_read\": " << stats.bytes_read
+           << ", \"bytes_written\": " << stats.bytes_written
+           << ", \"refills\": " << stats.refills
+           << ", \"drains\": " << stats.drains
+           << ", \"read_seconds\": " << stats.read_seconds
+           << ", \"write_seconds\": " << stats.write_seconds
+           << ", \"lex_seconds\": " << stats.lex_seconds
+           << ", \"line_comments\": " << stats.line_comments
+           << ", \"block_comments\": " << stats.block_comments
+           << ", \"strings\": " << stats.strings
+           << "}\n";
+}
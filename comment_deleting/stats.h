@@ -0,0 +1,34 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <chrono>
+#include <ostream>
+
+/*
+ * Counters filled by InputBuffer, OutputBuffer and BasicCommentParser
+ * once a StripStats is attached with set_stats(); without one they cost
+ * a pointer test per refill, drain and comment.
+ */
+struct StripStats {
+    long long bytes_read;
+    long long bytes_written;
+    long long refills;
+    long long drains;
+    //time spent waiting for input and for output to be taken
+    double read_seconds;
+    double write_seconds;
+    //scan time minus the waits above
+    double lex_seconds;
+    long long line_comments;
+    long long block_comments;
+    long long strings;
+
+    StripStats();
+};
+
+typedef std::chrono::steady_clock StatsClock;
+
+double seconds_since(StatsClock::time_point start);
+void write_json(std::ostream &output, const StripStats &stats);
+
+#endif // STATS_H
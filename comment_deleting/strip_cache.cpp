@@ -0,0 +1,200 @@
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+#include "strip_cache.h"
+
+using std::runtime_error;
+using std::string;
+using std::vector;
+
+static const uint64_t INDEX_MAGIC = 0x31786564696e7363ULL;
+static const uint64_t INITIAL_CAPACITY = 1024;
+static const uint64_t MAX_CAPACITY = uint64_t(1) << 40;
+
+/*
+ * Exclusive flock on the index for one operation: other processes may grow
+ * and remap the shared index file at any time otherwise.
+ */
+class IndexLock {
+private:
+    int fd_;
+public:
+    IndexLock(int fd):
+        fd_(fd)
+    {
+        while (flock(fd_, LOCK_EX) && errno == EINTR) {
+        }
+    }
+    ~IndexLock()
+    {
+        flock(fd_, LOCK_UN);
+    }
+};
+
+StripCache::StripCache(const string &directory):
+    directory_(directory),
+    fd_(-1),
+    header_(0),
+    entries_(0),
+    capacity_(0)
+{
+    mkdir(directory_.c_str(), 0777);
+
+    string index = directory_ + "/index";
+    fd_ = open(index.c_str(), O_RDWR | O_CREAT, 0666);
+    if (fd_ < 0) {
+        throw runtime_error("cannot open " + index);
+    }
+
+    try {
+        IndexLock lock(fd_);
+        struct stat status;
+        fstat(fd_, &status);
+        if (status.st_size < (off_t)sizeof(Header)) {
+            map(INITIAL_CAPACITY);
+            header_->magic = INDEX_MAGIC;
+            header_->capacity = INITIAL_CAPACITY;
+            header_->count = 0;
+            return;
+        }
+        map_existing();
+    } catch (...) {
+        unmap();
+        close(fd_);
+        throw;
+    }
+}
+
+//map an index written before, after checking that its header fits the file
+void StripCache::map_existing()
+{
+    Header header;
+    struct stat status;
+
+    if (fstat(fd_, &status) || pread(fd_, &header, sizeof(header), 0) != (ssize_t)sizeof(header)
+            || header.magic != INDEX_MAGIC
+            || !header.capacity || (header.capacity & (header.capacity - 1)) || header.capacity > MAX_CAPACITY
+            || header.count >= header.capacity
+            || status.st_size != (off_t)(sizeof(Header) + header.capacity * sizeof(Entry))) {
+        throw runtime_error("corrupted cache index in " + directory_);
+    }
+    unmap();
+    map(header.capacity);
+}
+
+//follow a grow() by another process, the index lock has to be held
+void StripCache::refresh()
+{
+    if (header_->capacity != capacity_) {
+        map_existing();
+    }
+}
+
+StripCache::~StripCache()
+{
+    unmap();
+    close(fd_);
+}
+
+void StripCache::map(uint64_t capacity)
+{
+    size_t length = sizeof(Header) + capacity * sizeof(Entry);
+
+    if (ftruncate(fd_, length)) {
+        throw runtime_error("cannot resize cache index in " + directory_);
+    }
+    void *memory = mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (memory == MAP_FAILED) {
+        throw runtime_error("cannot map cache index in " + directory_);
+    }
+    header_ = static_cast<Header *>(memory);
+    entries_ = reinterpret_cast<Entry *>(header_ + 1);
+    capacity_ = capacity;
+}
+
+void StripCache::unmap()
+{
+    if (header_) {
+        munmap(header_, sizeof(Header) + capacity_ * sizeof(Entry));
+        header_ = 0;
+        entries_ = 0;
+        capacity_ = 0;
+    }
+}
+
+StripCache::Entry *StripCache::slot(uint64_t hash, uint64_t size) const
+{
+    uint64_t mask = capacity_ - 1;
+
+    for (uint64_t i = hash & mask; ; i = (i + 1) & mask) {
+        if (!entries_[i].size || (entries_[i].hash == hash && entries_[i].size == size + 1)) {
+            return &entries_[i];
+        }
+    }
+}
+
+bool StripCache::find(uint64_t hash, uint64_t size)
+{
+    IndexLock lock(fd_);
+
+    refresh();
+    return slot(hash, size)->size != 0;
+}
+
+void StripCache::grow()
+{
+    vector<Entry> entries(entries_, entries_ + capacity_);
+    uint64_t capacity = capacity_ * 2;
+    uint64_t count = header_->count;
+
+    unmap();
+    map(capacity);
+    header_->magic = INDEX_MAGIC;
+    header_->capacity = capacity;
+    header_->count = count;
+    for (uint64_t i = 0; i < capacity; ++i) {
+        entries_[i].hash = 0;
+        entries_[i].size = 0;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].size) {
+            *slot(entries[i].hash, entries[i].size - 1) = entries[i];
+        }
+    }
+}
+
+void StripCache::insert(uint64_t hash, uint64_t size)
+{
+    IndexLock lock(fd_);
+
+    refresh();
+    Entry *entry = slot(hash, size);
+    if (entry->size) {
+        return;
+    }
+    //keep the load factor under 1/2
+    if (2 * (header_->count + 1) > capacity_) {
+        grow();
+        entry = slot(hash, size);
+    }
+
+    entry->hash = hash;
+    entry->size = size + 1;
+    ++header_->count;
+}
+
+string StripCache::path(uint64_t hash) const
+{
+    char name[32];
+
+    snprintf(name, sizeof(name), "/%016llx.strip", (unsigned long long)hash);
+    return directory_ + name;
+}
@@ -0,0 +1,47 @@
+#ifndef STRIP_CACHE_H
+#define STRIP_CACHE_H
+
+#include <cstdint>
+#include <string>
+
+/*
+ * On-disk cache of stripped files keyed by the content hash of the input.
+ * directory/index is an open addressing table mapped into memory,
+ * directory/<hash>.strip holds the stripped text. Processes sharing the
+ * directory serialize index operations with flock().
+ */
+class StripCache {
+private:
+    struct Header {
+        uint64_t magic;
+        uint64_t capacity;
+        uint64_t count;
+    };
+    struct Entry {
+        uint64_t hash;
+        //input size + 1, 0 marks an empty slot
+        uint64_t size;
+    };
+
+    std::string directory_;
+    int fd_;
+    Header *header_;
+    Entry *entries_;
+    //capacity of the current mapping, header_->capacity changes when another process grows the index
+    uint64_t capacity_;
+
+    void map(uint64_t capacity);
+    void map_existing();
+    void refresh();
+    void unmap();
+    void grow();
+    Entry *slot(uint64_t hash, uint64_t size) const;
+public:
+    StripCache(const std::string &directory);
+    ~StripCache();
+    bool find(uint64_t hash, uint64_t size);
+    void insert(uint64_t hash, uint64_t size);
+    std::string path(uint64_t hash) const;
+};
+
+#endif // STRIP_CACHE_H
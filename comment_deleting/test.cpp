@@ -1,15 +1,199 @@
+#include <cstring>
+#include <exception>
 #include <iostream>
+#include <string>
+#include <vector>
 
+#include "async_buffer.h"
+#include "batch.h"
 #include "comment_parser.h"
+#include "compressed_buffer.h"
+#include "mapped_file.h"
+#include "comment_parser_test.h"
 
 using std::cin;
 using std::cout;
+using std::string;
+using std::vector;
 
-int main()
+template <class Profile>
+static void strip_to_cout(BasicCommentParser<Profile> &parser, InputBuffer &input, Compression compression)
 {
-    CommentParser parser;
+    if (compression == NO_COMPRESSION) {
+        OutputBuffer output(cout, CommentParserBase::BUFFER_CAPACITY);
+
+        parser.delete_comments(input, output);
+        return;
+    }
+    CompressingOutputBuffer output(cout, CommentParserBase::BUFFER_CAPACITY, compression);
+
+    parser.delete_comments(input, output);
+    output.finish();
+}
+
+template <class Profile> int run(int argc, char *argv[], StripStats *stats)
+{
+    BasicCommentParser<Profile> parser;
+
+    parser.set_stats(stats);
+
+    if (argc > 2 && !strcmp(argv[1], "--batch")) {
+        string output_directory = argv[2];
+        string cache_directory;
+        bool link = false;
+        vector<string> inputs;
+
+        for (int i = 3; i < argc; ++i) {
+            if (!strcmp(argv[i], "--cache") && i + 1 < argc) {
+                cache_directory = argv[++i];
+            } else if (!strcmp(argv[i], "--link")) {
+                link = true;
+            } else {
+                inputs.push_back(argv[i]);
+            }
+        }
+
+        if (cache_directory.empty()) {
+            return strip_files(inputs, output_directory, strip_comments<Profile>,
+                               Profile::name(), 0, false, stats) ? 1 : 0;
+        }
+        StripCache cache(cache_directory);
+        return strip_files(inputs, output_directory, strip_comments<Profile>,
+                           Profile::name(), &cache, link, stats) ? 1 : 0;
+    }
+
+    //--blank: same length output, comments replaced with spaces in place
+    if (argc > 2 && !strcmp(argv[1], "--blank")) {
+        MappedFile file(argv[2]);
+
+        parser.blank_comments(file.data(), file.data() + file.size());
+        cout.write(file.data(), file.size());
+        if (stats) {
+            stats->bytes_written += file.size();
+        }
+        return 0;
+    }
+
+    //--spans: one "offset length kind" line per span
+    if (argc > 2 && !strcmp(argv[1], "--spans")) {
+        static const char *names[] = {"code", "line_comment", "block_comment", "string"};
+        MappedFile file(argv[2]);
+        vector<CommentParserBase::Span> spans;
+
+        parser.tokenize(file.data(), file.data() + file.size(), spans);
+        for (size_t i = 0; i < spans.size(); ++i) {
+            cout << spans[i].offset << " " << spans[i].length << " " << names[spans[i].kind] << "\n";
+        }
+        return 0;
+    }
+
+    //--async: overlap reading, parsing and writing in separate threads
+    if (argc > 1 && !strcmp(argv[1], "--async")) {
+        AsyncInputBuffer input(cin, CommentParserBase::BUFFER_CAPACITY);
+        AsyncOutputBuffer output(cout, CommentParserBase::BUFFER_CAPACITY);
+
+        parser.delete_comments(input, output);
+        return 0;
+    }
+
+    //--decompress: gzip/zstd input detected by magic, --compress gzip|zstd: compressed output
+    Compression compression = NO_COMPRESSION;
+    bool decompress = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--decompress")) {
+            decompress = true;
+        } else if (!strcmp(argv[i], "--compress") && i + 1 < argc) {
+            ++i;
+            if (!strcmp(argv[i], "gzip")) {
+                compression = GZIP;
+            } else if (!strcmp(argv[i], "zstd")) {
+                compression = ZSTD;
+            } else {
+                std::cerr << "unknown compression " << argv[i] << "\n";
+                return 1;
+            }
+        }
+    }
+    if (decompress) {
+        DecompressingInputBuffer input(cin, CommentParserBase::BUFFER_CAPACITY);
+
+        strip_to_cout(parser, input, compression);
+        return 0;
+    }
+    if (compression != NO_COMPRESSION) {
+        InputBuffer input(cin, CommentParserBase::BUFFER_CAPACITY);
+
+        strip_to_cout(parser, input, compression);
+        return 0;
+    }
 
     parser.delete_comments(cin, cout);
     return 0;
 }
 
+static int run(const char *language, int argc, char *argv[], StripStats *stats)
+{
+    if (!strcmp(language, ShellLanguage::name())) {
+        return run<ShellLanguage>(argc, argv, stats);
+    } else if (!strcmp(language, PythonLanguage::name())) {
+        return run<PythonLanguage>(argc, argv, stats);
+    } else if (!strcmp(language, SqlLanguage::name())) {
+        return run<SqlLanguage>(argc, argv, stats);
+    } else if (!strcmp(language, LuaLanguage::name())) {
+        return run<LuaLanguage>(argc, argv, stats);
+    } else if (!strcmp(language, CLanguage::name())) {
+        return run<CLanguage>(argc, argv, stats);
+    }
+    std::cerr << "unknown language " << language << "\n";
+    return 1;
+}
+
+/*
+ * usage:
+ *   test [--stats] [--language c|shell|python|sql|lua] mode
+ * where mode is one of
+ *   [--async] < input > output
+ *   [--decompress] [--compress gzip|zstd] < input > output
+ *   --batch output_dir [--cache cache_dir [--link]] file...
+ *   --blank file > output
+ *   --spans file
+ *   --self-test
+ * --stats prints StripStats as JSON to stderr.
+ */
+int main(int argc, char *argv[])
+{
+    const char *language = CLanguage::name();
+    StripStats stats;
+    bool print_stats = false;
+
+    while (argc > 1) {
+        if (!strcmp(argv[1], "--stats")) {
+            print_stats = true;
+            --argc;
+            ++argv;
+        } else if (argc > 2 && !strcmp(argv[1], "--language")) {
+            language = argv[2];
+            argc -= 2;
+            argv += 2;
+        } else {
+            break;
+        }
+    }
+
+    if (argc > 1 && !strcmp(argv[1], "--self-test")) {
+        test();
+        return 0;
+    }
+
+    int result;
+    try {
+        result = run(language, argc, argv, print_stats ? &stats : 0);
+    } catch (const std::exception &error) {
+        std::cerr << "error: " << error.what() << "\n";
+        return 1;
+    }
+    if (print_stats) {
+        write_json(std::cerr, stats);
+    }
+    return result;
+}
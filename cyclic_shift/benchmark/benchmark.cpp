@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "cyclic_shift.h"
+#include "parallel_rotate.h"
+
+using std::string;
+using std::vector;
+
+typedef std::chrono::steady_clock Clock;
+
+const long long SWAPS_MAX_LENGTH = 100000;
+//moves are counted on a wrapped copy of the data up to this length
+const long long COUNT_MAX_LENGTH = 1000000;
+//small arrays are rotated repeatedly, about this many elements per measurement
+const long long ELEMENTS_PER_MEASUREMENT = 10000000;
+//or for about this long, whichever comes first
+const double MEASUREMENT_SECONDS = 0.05;
+
+//trivially copyable element of a cache line
+struct Blob64 {
+    long long fields[8];
+};
+
+void fill(int &e, long long i) { e = (int)i; }
+void fill(double &e, long long i) { e = (double)i; }
+void fill(Blob64 &e, long long i) { std::fill(e.fields, e.fields + 8, i); }
+void fill(string &e, long long i) { e = "element " + std::to_string(i); }
+
+/*
+ * Counts every copy and move of the wrapped element. Moves the same way as E
+ * for the cycle leader and block swap paths; trivially copyable E loses the
+ * memmove kernel, whose block copies are not counted.
+ */
+template <typename E> struct Counted {
+    static long long moves;
+    E value;
+
+    Counted() {}
+    Counted(const Counted &other): value(other.value) { ++moves; }
+    Counted(Counted &&other): value(std::move(other.value)) { ++moves; }
+    Counted &operator =(const Counted &other)
+    {
+        value = other.value;
+        ++moves;
+        return *this;
+    }
+    Counted &operator =(Counted &&other)
+    {
+        value = std::move(other.value);
+        ++moves;
+        return *this;
+    }
+};
+
+template <typename E> long long Counted<E>::moves = 0;
+
+template <typename E> struct IsExpensiveToMove<Counted<E> > : IsExpensiveToMove<E> {};
+
+enum Method {SWAPS, CYCLIC_SHIFT, STD_ROTATE, PARALLEL, METHODS};
+
+const char *METHOD_NAMES[] = {"swaps", "cyclic_shift", "std::rotate", "parallel"};
+
+template <typename V> void apply(Method method, V &data, long long k)
+{
+    long long length = data.size();
+
+    if (method == SWAPS) {
+        rotate_swaps(data.begin(), (int)length, (int)k);
+    } else if (method == CYCLIC_SHIFT) {
+        cyclic_shift(data.begin(), data.end(), k);
+    } else if (method == STD_ROTATE) {
+        std::rotate(data.begin(), data.end() - k, data.end());
+    } else {
+        parallel_rotate(data.begin(), data.end() - 1, k);
+    }
+}
+
+struct Shift {
+    const char *name;
+    long long k;
+};
+
+long long gcd(long long a, long long b)
+{
+    while (b) {
+        long long t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+//small, half, coprime with n and sharing a large divisor with n, all in [1, n)
+vector<Shift> shifts(long long length)
+{
+    vector<Shift> result;
+    long long coprime = length / 3 + 1;
+    while (coprime > 1 && gcd(length, coprime) != 1) {
+        --coprime;
+    }
+    long long divisor = std::max(length / 16, 1LL);
+
+    Shift small = {"small", std::min(3LL, length - 1)};
+    Shift half = {"n/2", std::max(length / 2, 1LL)};
+    Shift relative = {"coprime", coprime};
+    Shift heavy = {"gcd-heavy", (3 * divisor < length) ? 3 * divisor : half.k};
+    result.push_back(small);
+    result.push_back(half);
+    result.push_back(relative);
+    result.push_back(heavy);
+    return result;
+}
+
+template <typename E> void run(const char *type, long long length)
+{
+    vector<E> data(length);
+    for (long long i = 0; i < length; ++i) {
+        fill(data[i], i);
+    }
+    long long repeats = std::max(ELEMENTS_PER_MEASUREMENT / length, 1LL);
+    vector<Shift> ks = shifts(length);
+
+    for (size_t s = 0; s < ks.size(); ++s) {
+        for (int m = 0; m < METHODS; ++m) {
+            Method method = Method(m);
+            //element swaps degrade to O(n^2 / (n - k)) when k is close to n
+            if (method == SWAPS && length > SWAPS_MAX_LENGTH) {
+                continue;
+            }
+
+            Clock::time_point start = Clock::now();
+            double elapsed = 0;
+            long long r = 0;
+            while (r < repeats && elapsed < MEASUREMENT_SECONDS) {
+                apply(method, data, ks[s].k);
+                ++r;
+                elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+            }
+            double seconds = elapsed / r;
+
+            char moves[32] = "-";
+            if ((method == CYCLIC_SHIFT || method == STD_ROTATE) && length <= COUNT_MAX_LENGTH) {
+                vector<Counted<E> > counted(length);
+                Counted<E>::moves = 0;
+                apply(method, counted, ks[s].k);
+                snprintf(moves, sizeof(moves), "%.2f", (double)Counted<E>::moves / length);
+            }
+
+            //every element is read and written at least once
+            double bandwidth = 2.0 * length * sizeof(E) / seconds / 1e9;
+            printf("%-7s %11lld %-9s %11lld %-12s %10.3f %8s %8.2f\n", type, length, ks[s].name,
+                   ks[s].k, METHOD_NAMES[m], seconds * 1e9 / length, moves, bandwidth);
+        }
+    }
+}
+
+template <typename E> void run_fitting(const char *type, long long length, long long max_bytes)
+{
+    if (length * (long long)sizeof(E) <= max_bytes) {
+        run<E>(type, length);
+    }
+}
+
+/*
+ * usage: benchmark [max_length [max_megabytes]]
+ * Sweeps lengths 10, 100, ... up to max_length (at most 10^9) over shift
+ * distributions and element types, skipping arrays above max_megabytes.
+ * Compares element swaps, cyclic_shift, std::rotate and parallel_rotate:
+ * ns per element, moves per element counted through a wrapper type
+ * (up to COUNT_MAX_LENGTH) and effective bandwidth in GB/s.
+ */
+int main(int argc, char *argv[])
+{
+    long long max_length = (argc > 1) ? atoll(argv[1]) : 10000000;
+    long long max_bytes = ((argc > 2) ? atoll(argv[2]) : 4096) << 20;
+
+    max_length = std::min(max_length, 1000000000LL);
+    printf("%-7s %11s %-9s %11s %-12s %10s %8s %8s\n",
+           "type", "n", "shift", "k", "method", "ns/elem", "moves", "GB/s");
+    for (long long length = 10; length <= max_length; length *= 10) {
+        run_fitting<int>("int", length, max_bytes);
+        run_fitting<double>("double", length, max_bytes);
+        run_fitting<Blob64>("blob64", length, max_bytes);
+        run_fitting<string>("string", length, max_bytes);
+    }
+
+    return 0;
+}
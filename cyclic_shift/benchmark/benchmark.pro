@@ -0,0 +1,15 @@
+TEMPLATE = app
+CONFIG += console
+CONFIG += thread
+CONFIG -= qt
+
+QMAKE_CXXFLAGS += -std=c++11
+
+INCLUDEPATH += ..
+
+SOURCES += \
+    benchmark.cpp
+
+HEADERS += \
+    ../cyclic_shift.h \
+    ../parallel_rotate.h
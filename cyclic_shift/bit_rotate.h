@@ -0,0 +1,136 @@
+#ifndef BIT_ROTATE_H
+#define BIT_ROTATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "cyclic_shift.h"
+
+/*
+ * Cyclic shift of packed bit arrays: bit i lives in words[i / 64] at
+ * position i % 64, the array holds nbits bits, bits of the last word
+ * past nbits are kept zero. Rotating to the right by k moves bit i to
+ * bit (i + k) mod nbits.
+ */
+
+const size_t WORD_BITS = 64;
+
+//bits [position, position + count) of words as the low bits of a word, count <= 64
+inline uint64_t read_bits(const uint64_t *words, size_t position, size_t count)
+{
+    if (!count) {
+        return 0;
+    }
+
+    size_t word = position / WORD_BITS;
+    size_t offset = position % WORD_BITS;
+    uint64_t value = words[word] >> offset;
+
+    if (offset + count > WORD_BITS) {
+        value |= words[word + 1] << (WORD_BITS - offset);
+    }
+    return (count == WORD_BITS) ? value : value & ((uint64_t(1) << count) - 1);
+}
+
+/*
+ * to[i] = 64 bits of from starting at bit offset of from[i], offset < 64.
+ * The funnel shift loop has no dependencies between iterations, so the
+ * compiler vectorizes it.
+ */
+inline void funnel_copy(uint64_t *to, const uint64_t *from, size_t offset, size_t count)
+{
+    if (!offset) {
+        for (size_t i = 0; i < count; ++i) {
+            to[i] = from[i];
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        to[i] = (from[i] >> offset) | (from[i + 1] << (WORD_BITS - offset));
+    }
+}
+
+//write from rotated to the right by k into to, the arrays must not overlap
+inline void rotate_bits_copy(const uint64_t *from, uint64_t *to, size_t nbits, std::ptrdiff_t k)
+{
+    if (!nbits) {
+        return;
+    }
+
+    size_t words = (nbits + WORD_BITS - 1) / WORD_BITS;
+    k %= (std::ptrdiff_t)nbits;
+    if (k < 0) {
+        k += nbits;
+    }
+    //source bit of the first bit of the current destination word
+    size_t start = k ? nbits - k : 0;
+
+    for (size_t w = 0; w < words; ) {
+        if (start + WORD_BITS <= nbits && w + 1 < words) {
+            //a run of words that do not wrap around, all with the same offset
+            size_t run = (nbits - start) / WORD_BITS;
+            if (run > words - 1 - w) {
+                run = words - 1 - w;
+            }
+            funnel_copy(to + w, from + start / WORD_BITS, start % WORD_BITS, run);
+            w += run;
+            start += run * WORD_BITS;
+        } else {
+            size_t count = (w + 1 < words) ? WORD_BITS : nbits - w * WORD_BITS;
+            size_t first = (nbits - start < count) ? nbits - start : count;
+            uint64_t value = read_bits(from, start, first);
+
+            //wrap around to bit 0, possibly more than once for short arrays
+            for (size_t done = first; done < count; ) {
+                size_t piece = (count - done < nbits) ? count - done : nbits;
+                value |= read_bits(from, 0, piece) << done;
+                done += piece;
+            }
+            to[w] = value;
+            ++w;
+            start += count;
+        }
+        start %= nbits;
+    }
+}
+
+/*
+ * In place. When nbits is a multiple of 64 this is a word rotation by
+ * k / 64 with cyclic_shift followed by one funnel shift pass by k % 64
+ * carrying bits across words; otherwise it goes through a copy.
+ */
+inline void rotate_bits(uint64_t *words, size_t nbits, std::ptrdiff_t k)
+{
+    if (!nbits) {
+        return;
+    }
+
+    size_t count = (nbits + WORD_BITS - 1) / WORD_BITS;
+    k %= (std::ptrdiff_t)nbits;
+    if (k < 0) {
+        k += nbits;
+    }
+    if (!k) {
+        return;
+    }
+
+    if (nbits % WORD_BITS) {
+        std::vector<uint64_t> copy(words, words + count);
+        rotate_bits_copy(&copy[0], words, nbits, k);
+        return;
+    }
+
+    cyclic_shift(words, words + count, k / WORD_BITS);
+
+    size_t shift = k % WORD_BITS;
+    if (shift) {
+        uint64_t carry = words[count - 1] >> (WORD_BITS - shift);
+        for (size_t w = count - 1; w > 0; --w) {
+            words[w] = (words[w] << shift) | (words[w - 1] >> (WORD_BITS - shift));
+        }
+        words[0] = (words[0] << shift) | carry;
+    }
+}
+
+#endif // BIT_ROTATE_H
@@ -0,0 +1,212 @@
+#ifndef CHUNKED_ARRAY_H
+#define CHUNKED_ARRAY_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "cyclic_shift.h"
+
+/*
+ * Random access iterator over the chunks of ChunkedArray. It is segmented:
+ * cyclic_shift rotates chunked arrays segment by segment.
+ */
+template <typename T, std::size_t ChunkSize> class ChunkedArrayIterator
+{
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef T &reference;
+    typedef T *pointer;
+    typedef std::ptrdiff_t difference_type;
+private:
+    std::vector<T> *chunks_;
+    difference_type index_;
+public:
+
+    ChunkedArrayIterator(): chunks_(0), index_(0) {}
+    ChunkedArrayIterator(std::vector<T> *chunks, difference_type index):
+        chunks_(chunks),
+        index_(index)
+    {
+    }
+    //elements stored contiguously from this one to the end of its chunk
+    difference_type available() const
+    {
+        return ChunkSize - index_ % ChunkSize;
+    }
+    reference operator *() const
+    {
+        return chunks_[index_ / ChunkSize][index_ % ChunkSize];
+    }
+    pointer operator ->() const
+    {
+        return &**this;
+    }
+    reference operator [](difference_type n) const
+    {
+        return *(*this + n);
+    }
+    ChunkedArrayIterator &operator ++()
+    {
+        ++index_;
+        return *this;
+    }
+    ChunkedArrayIterator operator ++(int)
+    {
+        ChunkedArrayIterator old(*this);
+        ++index_;
+        return old;
+    }
+    ChunkedArrayIterator &operator --()
+    {
+        --index_;
+        return *this;
+    }
+    ChunkedArrayIterator operator --(int)
+    {
+        ChunkedArrayIterator old(*this);
+        --index_;
+        return old;
+    }
+    ChunkedArrayIterator &operator +=(difference_type n)
+    {
+        index_ += n;
+        return *this;
+    }
+    ChunkedArrayIterator &operator -=(difference_type n)
+    {
+        index_ -= n;
+        return *this;
+    }
+    ChunkedArrayIterator operator +(difference_type n) const
+    {
+        return ChunkedArrayIterator(chunks_, index_ + n);
+    }
+    ChunkedArrayIterator operator -(difference_type n) const
+    {
+        return ChunkedArrayIterator(chunks_, index_ - n);
+    }
+    friend ChunkedArrayIterator operator +(difference_type n, const ChunkedArrayIterator &it)
+    {
+        return it + n;
+    }
+    difference_type operator -(const ChunkedArrayIterator &other) const
+    {
+        return index_ - other.index_;
+    }
+    bool operator ==(const ChunkedArrayIterator &other) const
+    {
+        return index_ == other.index_;
+    }
+    bool operator !=(const ChunkedArrayIterator &other) const
+    {
+        return index_ != other.index_;
+    }
+    bool operator <(const ChunkedArrayIterator &other) const
+    {
+        return index_ < other.index_;
+    }
+    bool operator >(const ChunkedArrayIterator &other) const
+    {
+        return index_ > other.index_;
+    }
+    bool operator <=(const ChunkedArrayIterator &other) const
+    {
+        return index_ <= other.index_;
+    }
+    bool operator >=(const ChunkedArrayIterator &other) const
+    {
+        return index_ >= other.index_;
+    }
+};
+
+template <typename T, std::size_t ChunkSize> struct SegmentTraits<ChunkedArrayIterator<T, ChunkSize> >
+{
+    static const bool is_segmented = true;
+
+    static std::ptrdiff_t available(const ChunkedArrayIterator<T, ChunkSize> &it)
+    {
+        return it.available();
+    }
+};
+
+/*
+ * Array stored in fixed size chunks of ChunkSize elements: growing it never
+ * moves elements and references stay valid, like std::deque at the back.
+ */
+template <typename T, std::size_t ChunkSize = 512> class ChunkedArray
+{
+public:
+    typedef ChunkedArrayIterator<T, ChunkSize> iterator;
+    typedef T value_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef std::size_t size_type;
+private:
+    //every chunk has capacity ChunkSize, only the last one is not full
+    std::vector<std::vector<T> > chunks_;
+    size_type size_;
+public:
+
+    ChunkedArray(): size_(0) {}
+    explicit ChunkedArray(size_type count, const T &value = T()): size_(0)
+    {
+        for (size_type i = 0; i < count; ++i) {
+            push_back(value);
+        }
+    }
+    template <typename I, typename = typename std::enable_if<!std::is_integral<I>::value>::type>
+    ChunkedArray(I first, I last): size_(0)
+    {
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    void push_back(const T &value)
+    {
+        if (size_ % ChunkSize == 0) {
+            chunks_.push_back(std::vector<T>());
+            chunks_.back().reserve(ChunkSize);
+        }
+        chunks_.back().push_back(value);
+        ++size_;
+    }
+    void pop_back()
+    {
+        chunks_.back().pop_back();
+        if (chunks_.back().empty()) {
+            chunks_.pop_back();
+        }
+        --size_;
+    }
+
+    size_type size() const
+    {
+        return size_;
+    }
+    bool empty() const
+    {
+        return !size_;
+    }
+    reference operator [](size_type i)
+    {
+        return chunks_[i / ChunkSize][i % ChunkSize];
+    }
+    const_reference operator [](size_type i) const
+    {
+        return chunks_[i / ChunkSize][i % ChunkSize];
+    }
+    iterator begin()
+    {
+        return iterator(chunks_.empty() ? 0 : &chunks_[0], 0);
+    }
+    iterator end()
+    {
+        return iterator(chunks_.empty() ? 0 : &chunks_[0], size_);
+    }
+};
+
+#endif // CHUNKED_ARRAY_H
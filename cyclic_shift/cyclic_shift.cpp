@@ -1,14 +1,426 @@
 #include <assert.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <forward_list>
+#include <fstream>
+#include <list>
+#include <string>
 #include <vector>
 
-using std::swap;
+#include "bit_rotate.h"
+#include "chunked_array.h"
+#include "cyclic_shift.h"
+#include "file_rotate.h"
+#include "fixed_rotate.h"
+#include "parallel_rotate.h"
+#include "ring_buffer.h"
+#include "roll.h"
+#include "rotated_view.h"
+
+using std::string;
 using std::vector;
 
 
 typedef double      TYPE;
 
-template <typename T> void rotate(T begin , T end, int k);
+//not trivially copyable, goes through rotate_swaps
+struct Item {
+    int value;
+
+    Item(int v = 0): value(v) {}
+    Item(const Item &other): value(other.value) {}
+    Item &operator =(const Item &other)
+    {
+        value = other.value;
+        return *this;
+    }
+    bool operator ==(const Item &other) const
+    {
+        return value == other.value;
+    }
+};
+
+//counts copies and moves, expensive to move by IsExpensiveToMove
+struct Counted {
+    static long moves;
+    int value;
+
+    Counted(int v = 0): value(v) {}
+    Counted(const Counted &other): value(other.value) { ++moves; }
+    Counted &operator =(const Counted &other)
+    {
+        value = other.value;
+        ++moves;
+        return *this;
+    }
+};
+
+long Counted::moves = 0;
+
+//trivially copyable but larger than ROTATE_BUFFER_SIZE, must not reach rotate_trivial
+struct Big {
+    int value;
+    char padding[5000];
+
+    Big(int v = 0): value(v) {}
+    bool operator ==(const Big &other) const
+    {
+        return value == other.value;
+    }
+};
+
+//the cycle leader path moves every element once plus one temporary per cycle
+void check_cycle_leader(int length, int k)
+{
+    vector<Counted> a(length);
+    for (int i = 0; i < length; ++i) {
+        a[i].value = i;
+    }
+
+    Counted::moves = 0;
+    cyclic_shift(a.begin(), a.end(), k);
+
+    int shift = ((k % length) + length) % length;
+    int cycles = shift ? length : 0;
+    for (int r = shift; r; ) {
+        int t = cycles % r;
+        cycles = r;
+        r = t;
+    }
+    assert(Counted::moves == (shift ? length + cycles : 0));
+    for (int i = 0; i < length; ++i) {
+        assert(a[(i + shift) % length].value == i);
+    }
+}
+
+//rotate against std::rotate over [0, length) for every kind of shift
+template <typename E> void check_rotate(int length)
+{
+    int shifts[] = {1, 2, 3, length / 2, length - 1, length, length + 7, -1, -length / 3};
+
+    for (size_t s = 0; s < sizeof(shifts) / sizeof(shifts[0]); ++s) {
+        vector<E> a;
+        vector<E> expected;
+        for (int i = 0; i < length; ++i) {
+            a.push_back(E(i));
+        }
+        expected = a;
+
+        int k = ((shifts[s] % length) + length) % length;
+        std::rotate(expected.begin(), expected.end() - k, expected.end());
+        rotate(a.begin(), a.end() - 1, shifts[s]);
+        assert(a == expected);
+    }
+}
+
+//cyclic_shift over a container of any iterator category against std::rotate on a vector
+template <typename C> void check_cyclic_shift(int length)
+{
+    int shifts[] = {0, 1, 2, length / 2, length - 1, length, length + 3, -1, -length / 3};
+
+    for (size_t s = 0; s < sizeof(shifts) / sizeof(shifts[0]); ++s) {
+        vector<int> expected;
+        for (int i = 0; i < length; ++i) {
+            expected.push_back(i);
+        }
+        C a(expected.begin(), expected.end());
+
+        int k = length ? ((shifts[s] % length) + length) % length : 0;
+        std::rotate(expected.begin(), expected.end() - k, expected.end());
+        cyclic_shift(a.begin(), a.end(), shifts[s]);
+        assert(vector<int>(a.begin(), a.end()) == expected);
+    }
+}
+
+//parallel_rotate with a forced number of threads against std::rotate
+void check_parallel_rotate(int length, unsigned threads)
+{
+    int shifts[] = {1, length / 3, length / 2, length - 5, -7};
+
+    for (size_t s = 0; s < sizeof(shifts) / sizeof(shifts[0]); ++s) {
+        vector<int> a(length);
+        for (int i = 0; i < length; ++i) {
+            a[i] = i;
+        }
+        vector<int> expected = a;
+
+        int k = ((shifts[s] % length) + length) % length;
+        std::rotate(expected.begin(), expected.end() - k, expected.end());
+        parallel_rotate(a.begin(), a.end() - 1, shifts[s], threads);
+        assert(a == expected);
+    }
+}
+
+//parallel_reverse of two ranges against std::reverse, threads 0 and 1 run inline
+void check_parallel_reverse(unsigned threads)
+{
+    vector<int> a(1001);
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = i;
+    }
+    vector<int> expected = a;
+    std::reverse(expected.begin(), expected.begin() + 300);
+    std::reverse(expected.begin() + 300, expected.end());
+
+    vector<int>::iterator begins[] = {a.begin(), a.begin() + 300};
+    std::ptrdiff_t lengths[] = {300, 701};
+    parallel_reverse(begins, lengths, 2, threads);
+    assert(a == expected);
+}
+
+//rotate a file of 12-byte records both ways and compare with std::rotate
+void check_rotate_file(int records, long long k, size_t block_size)
+{
+    const char *path = "cyclic_shift_test.bin";
+    const size_t record_size = 12;
+    vector<char> data(records * record_size);
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = char(i * 7 + i / record_size);
+    }
+    vector<char> expected = data;
+    long long shift = ((k % records) + records) % records;
+    std::rotate(expected.begin(), expected.end() - shift * record_size, expected.end());
+
+    for (int method = 0; method < 2; ++method) {
+        std::ofstream(path, std::ios::binary).write(&data[0], data.size());
+
+        bool done = method ? rotate_file_blocks(path, record_size, k, block_size)
+                           : rotate_file(path, record_size, k);
+        assert(done);
+
+        vector<char> result(data.size());
+        std::ifstream(path, std::ios::binary).read(&result[0], result.size());
+        assert(result == expected);
+    }
+    remove(path);
+}
+
+//a view shifted several times reads like the rotated range and materializes to it
+void check_rotated_view(int length)
+{
+    vector<int> a(length);
+    for (int i = 0; i < length; ++i) {
+        a[i] = i;
+    }
+    vector<int> expected = a;
+    RotatedView<vector<int>::iterator> view(a.begin(), a.end(), 3);
+
+    view.shift(-10);
+    view.shift(length + 2);
+    rotate(expected.begin(), expected.end() - 1, 3 - 10 + length + 2);
+    assert(vector<int>(view.begin(), view.end()) == expected);
+    for (int i = 0; i < length; ++i) {
+        assert(view[i] == expected[i]);
+        assert(*(view.end() - (length - i)) == expected[i]);
+    }
+    assert(view.end() - view.begin() == length);
+    assert(*(1 + view.begin()) == view[1 % length]);
+    assert(std::is_sorted(a.begin(), a.end()));
+
+    view.materialize();
+    assert(a == expected);
+    assert(view.pending() == 0);
+    assert(vector<int>(view.begin(), view.end()) == expected);
+
+    //writes go through to the underlying range
+    view[0] = -1;
+    assert(a[0] == -1);
+}
+
+//roll and roll_copy against the index formula on a 3-d array
+void check_roll(size_t d0, size_t d1, size_t d2, int s0, int s1, int s2)
+{
+    vector<size_t> shape;
+    shape.push_back(d0);
+    shape.push_back(d1);
+    shape.push_back(d2);
+    vector<std::ptrdiff_t> shifts;
+    shifts.push_back(s0);
+    shifts.push_back(s1);
+    shifts.push_back(s2);
+
+    vector<int> a(d0 * d1 * d2);
+    vector<int> expected(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = i;
+    }
+    for (size_t i = 0; i < d0; ++i) {
+        for (size_t j = 0; j < d1; ++j) {
+            for (size_t k = 0; k < d2; ++k) {
+                size_t ti = roll_shift(i + s0, d0);
+                size_t tj = roll_shift(j + s1, d1);
+                size_t tk = roll_shift(k + s2, d2);
+                expected[(ti * d1 + tj) * d2 + tk] = a[(i * d1 + j) * d2 + k];
+            }
+        }
+    }
+
+    vector<int> copy(a.size());
+    roll_copy(&a[0], &copy[0], shape, shifts);
+    assert(copy == expected);
+    roll(&a[0], shape, shifts);
+    assert(a == expected);
+}
+
+//rotate_bits and rotate_bits_copy against rotating unpacked bits
+void check_rotate_bits(size_t nbits, std::ptrdiff_t k)
+{
+    size_t count = (nbits + 63) / 64;
+    vector<uint64_t> words(count, 0);
+    vector<char> bits(nbits);
+    unsigned seed = 12345;
+
+    for (size_t i = 0; i < nbits; ++i) {
+        seed = seed * 1103515245 + 12345;
+        bits[i] = (seed >> 16) & 1;
+        words[i / 64] |= uint64_t(bits[i]) << (i % 64);
+    }
+    if (nbits) {
+        cyclic_shift(bits.begin(), bits.end(), k);
+    }
+
+    vector<uint64_t> copy(count, ~uint64_t(0));
+    if (nbits) {
+        rotate_bits_copy(&words[0], &copy[0], nbits, k);
+        rotate_bits(&words[0], nbits, k);
+    }
+    for (size_t i = 0; i < nbits; ++i) {
+        assert(((words[i / 64] >> (i % 64)) & 1) == (uint64_t)bits[i]);
+        assert(((copy[i / 64] >> (i % 64)) & 1) == (uint64_t)bits[i]);
+    }
+    if (nbits % 64) {
+        assert(!(copy[count - 1] >> (nbits % 64)));
+    }
+}
+
+//rotate_batch<N> against cyclic_shift of each window
+template <std::size_t N, typename E> void check_rotate_batch()
+{
+    const std::size_t count = 3 * N + 5;
+    vector<E> windows(count * N);
+    vector<std::ptrdiff_t> shifts(count);
+
+    for (std::size_t i = 0; i < windows.size(); ++i) {
+        windows[i] = E(int(i));
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        shifts[i] = (std::ptrdiff_t)i - (std::ptrdiff_t)N - 2;
+    }
+
+    vector<E> expected(windows);
+    for (std::size_t i = 0; i < count; ++i) {
+        cyclic_shift(expected.begin() + i * N, expected.begin() + (i + 1) * N, shifts[i]);
+    }
+    rotate_batch<N>(&windows[0], count, &shifts[0]);
+    assert(windows == expected);
+}
+
+#ifdef FIXED_ROTATE_PERMUTE
+//the register kernel of N element windows of E against the copy, for every shift
+template <std::size_t N, typename E> void check_permute()
+{
+    static_assert(IsPermutable<N, E>::value, "window has no register kernel");
+    if (!window_permute_supported(N * sizeof(E))) {
+        return;
+    }
+
+    for (std::size_t k = 1; k < N; ++k) {
+        E window[N];
+        E expected[N];
+        for (std::size_t i = 0; i < N; ++i) {
+            window[i] = expected[i] = E(int(3 * i + 1));
+        }
+        permute_window(window, N * sizeof(E), k * sizeof(E));
+        rotate_window<N>(expected, k, std::false_type());
+        assert(std::equal(window, window + N, expected));
+    }
+}
+#endif
+
+//random pushes, pops and rotations of RingBuffer against std::deque
+template <typename E> void check_ring_buffer(int operations, std::size_t capacity)
+{
+    RingBuffer<E> ring(capacity);
+    std::deque<E> model;
+    unsigned seed = 777;
+
+    for (int i = 0; i < operations; ++i) {
+        seed = seed * 1103515245 + 12345;
+        unsigned choice = (seed >> 16) % 8;
+        E value = E(int(seed >> 20));
+
+        if (choice < 2 || model.empty()) {
+            ring.push_back(value);
+            model.push_back(value);
+        } else if (choice < 4) {
+            ring.push_front(value);
+            model.push_front(value);
+        } else if (choice == 4) {
+            ring.pop_back();
+            model.pop_back();
+        } else if (choice == 5) {
+            ring.pop_front();
+            model.pop_front();
+        } else {
+            std::ptrdiff_t k = int(seed >> 8) % 100 - 50;
+            ring.rotate(k);
+            cyclic_shift(model.begin(), model.end(), k);
+        }
+
+        assert(ring.size() == model.size());
+        if (!model.empty()) {
+            assert(ring.front() == model.front() && ring.back() == model.back());
+        }
+        if (i % 97 == 0) {
+            for (std::size_t j = 0; j < model.size(); ++j) {
+                assert(ring[j] == model[j]);
+            }
+            E *data = ring.linearize();
+            assert(model.empty() || std::equal(model.begin(), model.end(), data));
+        }
+    }
+}
+
+//the first push or pop after rotate(k) of a non-full RingBuffer moves min(k, size - k) elements, later ones O(1)
+void check_ring_buffer_rotate()
+{
+    RingBuffer<Counted> ring(64);
+    std::deque<int> model;
+    const std::ptrdiff_t shifts[] = {3, -3, 37, 20, 1, 0, -41};
+
+    for (int i = 0; i < 40; ++i) {
+        ring.push_back(Counted(i));
+        model.push_back(i);
+    }
+    for (std::size_t s = 0; s < sizeof(shifts) / sizeof(shifts[0]); ++s) {
+        std::ptrdiff_t size = model.size();
+        std::ptrdiff_t k = ((shifts[s] % size) + size) % size;
+        ring.rotate(shifts[s]);
+        cyclic_shift(model.begin(), model.end(), shifts[s]);
+
+        Counted::moves = 0;
+        ring.push_back(Counted(100 + int(s)));
+        model.push_back(100 + int(s));
+        assert(Counted::moves <= 4 * std::min(k, size - k) + 2);
+
+        Counted::moves = 0;
+        ring.pop_front();
+        model.pop_front();
+        ring.push_front(Counted(200 + int(s)));
+        model.push_front(200 + int(s));
+        ring.pop_back();
+        model.pop_back();
+        assert(Counted::moves <= 12);
+
+        assert(ring.size() == model.size());
+        for (std::size_t i = 0; i < model.size(); ++i) {
+            assert(ring[i].value == model[i]);
+        }
+    }
+}
 
 int main()
 {
@@ -48,41 +460,108 @@ int main()
         }
     }
 
-    return 0;
-}
+    //memmove path: buffered and block swaps
+    check_rotate<int>(1000);
+    check_rotate<int>(100003);
+    check_rotate<double>(54321);
+    check_rotate<char>(70001);
+    check_rotate<Big>(5);
+    check_rotate<Big>(64);
+    //cycle leader path
+    check_rotate<Item>(1001);
+    check_cycle_leader(1000, 1);
+    check_cycle_leader(1000, 250);
+    check_cycle_leader(999, -7);
+    check_cycle_leader(12, 12);
 
- template <typename T> void rotate(T begin , T end, int k)
-{
-    if (0 == k) {
-        return;
-    }
+    //forward, bidirectional and random access paths
+    check_cyclic_shift<std::forward_list<int> >(0);
+    check_cyclic_shift<std::forward_list<int> >(1);
+    check_cyclic_shift<std::forward_list<int> >(1000);
+    check_cyclic_shift<std::list<int> >(999);
+    check_cyclic_shift<std::deque<int> >(1003);
+    check_cyclic_shift<std::deque<int> >(2);
 
-    int  length = end - begin + 1;
-    k = k % length;
-    if (k < 0)  {
-        k = length + k;
+    //segment by segment paths
+    check_cyclic_shift<std::deque<double> >(100003);
+    check_cyclic_shift<ChunkedArray<int, 64> >(1000);
+    check_cyclic_shift<ChunkedArray<int, 64> >(64);
+    check_cyclic_shift<ChunkedArray<short> >(5000);
+
+    check_roll(1, 1, 1, 5, -3, 2);
+    check_roll(4, 5, 6, 1, 2, 3);
+    check_roll(7, 1, 300, -8, 4, 1001);
+    check_roll(64, 64, 3, 32, -1, 0);
+
+    size_t sizes[] = {1, 5, 63, 64, 65, 100, 128, 1000, 4096, 100003};
+    std::ptrdiff_t bit_shifts[] = {0, 1, 3, 63, 64, 65, 127, 500, -1, -70, 100003};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        for (size_t j = 0; j < sizeof(bit_shifts) / sizeof(bit_shifts[0]); ++j) {
+            check_rotate_bits(sizes[i], bit_shifts[j]);
+        }
     }
 
-    int number_blocks;
-    int modulo = 1;
+    check_rotate_batch<1, int>();
+    check_rotate_batch<4, int>();
+    check_rotate_batch<8, int>();
+    check_rotate_batch<8, float>();
+    check_rotate_batch<4, double>();
+    check_rotate_batch<4, long long>();
+    check_rotate_batch<16, short>();
+    check_rotate_batch<64, char>();
+    check_rotate_batch<16, char>();
+    check_rotate_batch<32, char>();
+    check_rotate_batch<32, short>();
+    check_rotate_batch<16, int>();
+    check_rotate_batch<8, double>();
+    check_rotate_batch<5, Item>();
+#ifdef FIXED_ROTATE_PERMUTE
+    //16 bytes: SSSE3 byte shuffle
+    check_permute<16, char>();
+    check_permute<8, short>();
+    check_permute<4, int>();
+    check_permute<2, double>();
+    //32 bytes: dword permute, byte shuffle across halves
+    check_permute<8, int>();
+    check_permute<4, long long>();
+    check_permute<16, short>();
+    check_permute<32, char>();
+    //64 bytes: two registers
+    check_permute<64, char>();
+    check_permute<32, short>();
+    check_permute<16, float>();
+    check_permute<8, double>();
+#endif
 
-    while (modulo) {
-        number_blocks = length / k;
-        modulo = length % k;
+    check_ring_buffer<int>(20000, 1);
+    check_ring_buffer<int>(20000, 64);
+    check_ring_buffer<Item>(5000, 0);
+    check_ring_buffer_rotate();
 
-        //поменять блоками по k
-        for (int i = 0; i < number_blocks; ++i) {
-            for (int j = 0; j < k; ++j) {
-                swap(begin[j], begin[k*i + j]);
-            }
-        }
-        //поменять остаток
-        for (int i = 0; i < modulo; ++i) {
-            swap(begin[i], begin[number_blocks * k + i]);
-        }
-        //сдвинуть начало последовательности из k элементов на (k - modulo)
-        length = k;
-        k = k - modulo;
-    };
-}
+    check_rotated_view(1);
+    check_rotated_view(17);
+    check_rotated_view(1000);
+
+    check_parallel_rotate(PARALLEL_ROTATE_MIN_LENGTH + 3, 3);
+    check_parallel_rotate(PARALLEL_ROTATE_MIN_LENGTH * 2 + 1, 8);
+    check_parallel_rotate(1000, 4);
+    check_parallel_reverse(0);
+    check_parallel_reverse(1);
+    check_parallel_reverse(3);
 
+    check_rotate_file(1000, 3, 100);
+    check_rotate_file(1000, 500, 100);
+    check_rotate_file(1001, -333, 64);
+    check_rotate_file(5000, 4999, 1 << 20);
+    check_rotate_file(17, 34, 8);
+    assert(!rotate_file_blocks("no/such/file", 4, 1));
+
+    vector<string> words;
+    words.push_back("a");
+    words.push_back("b");
+    words.push_back("c");
+    rotate(words.begin(), words.end() - 1, 1);
+    assert(words[0] == "c" && words[1] == "a" && words[2] == "b");
+
+    return 0;
+}
@@ -0,0 +1,368 @@
+#ifndef CYCLIC_SHIFT_H
+#define CYCLIC_SHIFT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+using std::swap;
+
+/*
+ * Shift [begin, end] (end inclusive) to the right by k positions,
+ * k may be negative or exceed the length. Same as cyclic_shift(begin, end + 1, k).
+ */
+template <typename T> void rotate(T begin , T end, int k);
+
+//temporary buffer of rotate_trivial, bytes
+const size_t ROTATE_BUFFER_SIZE = 4096;
+
+//iterators over elements laid out contiguously in memory
+template <typename T, typename V = typename std::iterator_traits<T>::value_type>
+struct IsContiguous : std::integral_constant<bool, std::is_pointer<T>::value
+        || (!std::is_same<V, bool>::value
+            && (std::is_same<T, typename std::vector<V>::iterator>::value
+                || std::is_same<T, typename std::vector<V>::const_iterator>::value))> {};
+
+/*
+ * Element types whose moves are costly enough to prefer the cycle leader
+ * rotate, which moves every element once, over block swaps, which take
+ * three moves per swap. Specialize for types with cheap moves.
+ */
+template <typename V>
+struct IsExpensiveToMove : std::integral_constant<bool, (sizeof(V) > 64)
+        || !std::is_trivially_copyable<V>::value> {};
+
+/*
+ * Element by element block swaps, the original rotate algorithm, kept as
+ * the benchmark baseline. Degrades to O(length^2 / (length - k)) for k
+ * close to length. 0 < k < length.
+ */
+template <typename T> void rotate_swaps(T begin, int length, int k)
+{
+    int number_blocks;
+    int modulo = 1;
+
+    while (modulo) {
+        number_blocks = length / k;
+        modulo = length % k;
+
+        //поменять блоками по k
+        for (int i = 0; i < number_blocks; ++i) {
+            for (int j = 0; j < k; ++j) {
+                swap(begin[j], begin[k*i + j]);
+            }
+        }
+        //поменять остаток
+        for (int i = 0; i < modulo; ++i) {
+            swap(begin[i], begin[number_blocks * k + i]);
+        }
+        //сдвинуть начало последовательности из k элементов на (k - modulo)
+        length = k;
+        k = k - modulo;
+    };
+}
+
+//exchange [first, first + length) and [second, second + length), the ranges do not overlap
+template <typename T> void swap_blocks(T *first, T *second, size_t length)
+{
+    char buffer[ROTATE_BUFFER_SIZE];
+    size_t step = sizeof(buffer) / sizeof(T);
+
+    for (size_t done = 0; done < length; done += step) {
+        size_t count = (length - done < step) ? length - done : step;
+        size_t bytes = count * sizeof(T);
+
+        memcpy(buffer, first + done, bytes);
+        memcpy(first + done, second + done, bytes);
+        memcpy(second + done, buffer, bytes);
+    }
+}
+
+/*
+ * Move [begin, begin + length) to the left by left positions through
+ * a stack buffer, min(left, length - left) elements have to fit in it.
+ */
+template <typename T> void rotate_buffered(T *begin, size_t length, size_t left)
+{
+    char buffer[ROTATE_BUFFER_SIZE];
+    size_t right = length - left;
+
+    if (left <= right) {
+        memcpy(buffer, begin, left * sizeof(T));
+        memmove(begin, begin + left, right * sizeof(T));
+        memcpy(begin + right, buffer, left * sizeof(T));
+    } else {
+        memcpy(buffer, begin + left, right * sizeof(T));
+        memmove(begin + right, begin, left * sizeof(T));
+        memcpy(begin, buffer, right * sizeof(T));
+    }
+}
+
+/*
+ * Rotation of trivially copyable elements with memcpy/memmove block moves,
+ * sizeof(T) <= ROTATE_BUFFER_SIZE:
+ * a single buffered pass when the shorter part fits ROTATE_BUFFER_SIZE,
+ * otherwise Gries-Mills block swaps until it does.
+ * Shifts [begin, begin + length) to the right by k, 0 < k < length.
+ */
+template <typename T> void rotate_trivial(T *begin, size_t length, size_t k)
+{
+    const size_t buffered = ROTATE_BUFFER_SIZE / sizeof(T);
+    //left block [begin + middle - i, begin + middle), right block [begin + middle, begin + middle + j)
+    size_t middle = length - k;
+    size_t i = middle;
+    size_t j = k;
+
+    for (;;) {
+        if (i <= buffered || j <= buffered) {
+            rotate_buffered(begin + middle - i, i + j, i);
+            return;
+        }
+        if (i == j) {
+            break;
+        }
+        if (i < j) {
+            swap_blocks(begin + middle - i, begin + middle + j - i, i);
+            j -= i;
+        } else {
+            swap_blocks(begin + middle - i, begin + middle, j);
+            i -= j;
+        }
+    }
+    swap_blocks(begin + middle - i, begin + middle, i);
+}
+
+/*
+ * Gries-Mills block swaps with swap_ranges for any random access iterator.
+ * Shifts [begin, begin + length) to the right by k, 0 < k < length.
+ */
+template <typename T> void rotate_block_swap(T begin, std::ptrdiff_t length, std::ptrdiff_t k)
+{
+    std::ptrdiff_t middle = length - k;
+    std::ptrdiff_t i = middle;
+    std::ptrdiff_t j = k;
+
+    while (i != j) {
+        if (i < j) {
+            std::swap_ranges(begin + middle - i, begin + middle, begin + middle + j - i);
+            j -= i;
+        } else {
+            std::swap_ranges(begin + middle - i, begin + middle - i + j, begin + middle);
+            i -= j;
+        }
+    }
+    std::swap_ranges(begin + middle - i, begin + middle, begin + middle);
+}
+
+/*
+ * Segmented iterators walk a sequence of contiguous segments, like the
+ * blocks of std::deque or the chunks of ChunkedArray. Specializations set
+ * is_segmented and provide available(it): the number of elements stored
+ * contiguously from it to the end of its segment.
+ */
+template <typename T> struct SegmentTraits
+{
+    static const bool is_segmented = false;
+};
+
+/*
+ * std::deque has no public segment interface, so this reads the private
+ * _M_cur/_M_last members of libstdc++'s deque iterator. With libc++, MSVC
+ * or a libstdc++ that renames them, std::deque falls back to the plain
+ * random access rotate; ChunkedArray is segmented everywhere.
+ */
+#ifdef __GLIBCXX__
+template <typename V, typename R, typename P> struct SegmentTraits<std::_Deque_iterator<V, R, P> >
+{
+    static const bool is_segmented = true;
+
+    static std::ptrdiff_t available(const std::_Deque_iterator<V, R, P> &it)
+    {
+        return it._M_last - it._M_cur;
+    }
+};
+#endif
+
+//swap_ranges of [first, first + length) and [second, ...) one contiguous run at a time
+template <typename T> void swap_segments(T first, T second, std::ptrdiff_t length)
+{
+    typedef SegmentTraits<T> Traits;
+
+    while (length) {
+        std::ptrdiff_t run = std::min(length, std::min(Traits::available(first), Traits::available(second)));
+
+        std::swap_ranges(&*first, &*first + run, &*second);
+        first += run;
+        second += run;
+        length -= run;
+    }
+}
+
+/*
+ * Gries-Mills block swaps for segmented iterators, every block swap runs
+ * over raw pointers within segments.
+ * Shifts [begin, begin + length) to the right by k, 0 < k < length.
+ */
+template <typename T> void rotate_segmented(T begin, std::ptrdiff_t length, std::ptrdiff_t k)
+{
+    std::ptrdiff_t middle = length - k;
+    std::ptrdiff_t i = middle;
+    std::ptrdiff_t j = k;
+
+    while (i != j) {
+        if (i < j) {
+            swap_segments(begin + middle - i, begin + middle + j - i, i);
+            j -= i;
+        } else {
+            swap_segments(begin + middle - i, begin + middle, j);
+            i -= j;
+        }
+    }
+    swap_segments(begin + middle - i, begin + middle, i);
+}
+
+/*
+ * Cycle leader (juggling) rotation: gcd(length, k) cycles, each element
+ * is moved exactly once plus one temporary per cycle, length + gcd moves.
+ * Shifts [begin, begin + length) to the right by k, 0 < k < length.
+ */
+template <typename T> void rotate_cycle_leader(T begin, std::ptrdiff_t length, std::ptrdiff_t k)
+{
+    std::ptrdiff_t cycles = length;
+    for (std::ptrdiff_t r = k; r; ) {
+        std::ptrdiff_t t = cycles % r;
+        cycles = r;
+        r = t;
+    }
+    //begin[i] takes the element from begin[i + step]
+    std::ptrdiff_t step = length - k;
+
+    for (std::ptrdiff_t leader = 0; leader < cycles; ++leader) {
+        typename std::iterator_traits<T>::value_type temporary = std::move(begin[leader]);
+        std::ptrdiff_t i = leader;
+
+        for (;;) {
+            std::ptrdiff_t next = (i < k) ? i + step : i - k;
+            if (next == leader) {
+                break;
+            }
+            begin[i] = std::move(begin[next]);
+            i = next;
+        }
+        begin[i] = std::move(temporary);
+    }
+}
+
+template <typename T>
+void rotate_random_access(T begin, std::ptrdiff_t length, std::ptrdiff_t k, std::true_type)
+{
+    rotate_trivial(&*begin, length, k);
+}
+
+template <typename T>
+void rotate_moves(T begin, std::ptrdiff_t length, std::ptrdiff_t k, std::true_type)
+{
+    rotate_cycle_leader(begin, length, k);
+}
+
+template <typename T>
+void rotate_swapping(T begin, std::ptrdiff_t length, std::ptrdiff_t k, std::true_type)
+{
+    rotate_segmented(begin, length, k);
+}
+
+template <typename T>
+void rotate_swapping(T begin, std::ptrdiff_t length, std::ptrdiff_t k, std::false_type)
+{
+    rotate_block_swap(begin, length, k);
+}
+
+template <typename T>
+void rotate_moves(T begin, std::ptrdiff_t length, std::ptrdiff_t k, std::false_type)
+{
+    rotate_swapping(begin, length, k, std::integral_constant<bool, SegmentTraits<T>::is_segmented>());
+}
+
+template <typename T>
+void rotate_random_access(T begin, std::ptrdiff_t length, std::ptrdiff_t k, std::false_type)
+{
+    rotate_moves(begin, length, k, IsExpensiveToMove<typename std::iterator_traits<T>::value_type>());
+}
+
+//forward iterators: the single pass Gries-Mills swap loop
+template <typename T>
+void cyclic_shift(T first, T last, std::ptrdiff_t length, std::ptrdiff_t k, std::forward_iterator_tag)
+{
+    T middle = first;
+    std::advance(middle, length - k);
+    T next = middle;
+
+    while (first != next) {
+        swap(*first++, *next++);
+        if (next == last) {
+            next = middle;
+        } else if (first == middle) {
+            middle = next;
+        }
+    }
+}
+
+//bidirectional iterators: three reversals, (AB)' = B'A'
+template <typename T>
+void cyclic_shift(T first, T last, std::ptrdiff_t length, std::ptrdiff_t k, std::bidirectional_iterator_tag)
+{
+    T middle = first;
+    std::advance(middle, length - k);
+
+    std::reverse(first, middle);
+    std::reverse(middle, last);
+    std::reverse(first, last);
+}
+
+/*
+ * random access iterators: memmove kernel for trivially copyable contiguous data
+ * whose elements fit ROTATE_BUFFER_SIZE, cycle leader for elements expensive to move, block swaps otherwise,
+ * segment by segment for segmented iterators
+ */
+template <typename T>
+void cyclic_shift(T first, T, std::ptrdiff_t length, std::ptrdiff_t k, std::random_access_iterator_tag)
+{
+    typedef typename std::iterator_traits<T>::value_type value_type;
+
+    rotate_random_access(first, length, k, std::integral_constant<bool,
+                         IsContiguous<T>::value && std::is_trivially_copyable<value_type>::value
+                         && sizeof(value_type) <= ROTATE_BUFFER_SIZE>());
+}
+
+/*
+ * Shift [first, last) to the right by k positions, k may be negative
+ * or exceed the length. The algorithm is chosen by iterator category.
+ */
+template <typename T> void cyclic_shift(T first, T last, std::ptrdiff_t k)
+{
+    std::ptrdiff_t length = std::distance(first, last);
+
+    if (length < 2) {
+        return;
+    }
+    k %= length;
+    if (k < 0) {
+        k += length;
+    }
+    if (0 == k) {
+        return;
+    }
+
+    cyclic_shift(first, last, length, k, typename std::iterator_traits<T>::iterator_category());
+}
+
+template <typename T> void rotate(T begin , T end, int k)
+{
+    cyclic_shift(begin, std::next(end), k);
+}
+
+#endif // CYCLIC_SHIFT_H
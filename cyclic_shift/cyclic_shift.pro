@@ -1,9 +1,21 @@
 TEMPLATE = app
 CONFIG += console
+CONFIG += thread
 CONFIG -= qt
 
-SOURCES += \
-    cyclic_shift.cpp
+QMAKE_CXXFLAGS += -std=c++11
 
-HEADERS +=
+SOURCES += \
+    cyclic_shift.cpp \
+    file_rotate.cpp
 
+HEADERS += \
+    cyclic_shift.h \
+    parallel_rotate.h \
+    file_rotate.h \
+    rotated_view.h \
+    roll.h \
+    bit_rotate.h \
+    fixed_rotate.h \
+    chunked_array.h \
+    ring_buffer.h
@@ -0,0 +1,185 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "cyclic_shift.h"
+#include "file_rotate.h"
+
+using std::string;
+using std::vector;
+
+//open path and turn k records into a right shift in bytes, 0 < shift < size
+static int open_for_rotate(const string &path, size_t record_size, long long k,
+                           off_t &size, off_t &shift)
+{
+    int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) || !record_size || status.st_size % record_size) {
+        close(fd);
+        return -1;
+    }
+    size = status.st_size;
+
+    long long records = size / record_size;
+    shift = 0;
+    if (records) {
+        k %= records;
+        if (k < 0) {
+            k += records;
+        }
+        shift = k * record_size;
+    }
+    return fd;
+}
+
+bool rotate_file(const string &path, size_t record_size, long long k)
+{
+    off_t size;
+    off_t shift;
+    int fd = open_for_rotate(path, record_size, k, size, shift);
+
+    if (fd < 0) {
+        return false;
+    }
+    if (!shift) {
+        close(fd);
+        return true;
+    }
+
+    void *memory = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+    char *data = static_cast<char *>(memory);
+
+    madvise(data, size, MADV_SEQUENTIAL);
+    rotate_trivial(data, size, shift);
+    bool synced = !msync(data, size, MS_SYNC);
+    munmap(data, size);
+
+    return synced;
+}
+
+static bool read_all(int fd, char *buffer, size_t length, off_t offset)
+{
+    while (length) {
+        ssize_t done = pread(fd, buffer, length, offset);
+        if (done <= 0) {
+            return false;
+        }
+        buffer += done;
+        length -= done;
+        offset += done;
+    }
+    return true;
+}
+
+static bool write_all(int fd, const char *buffer, size_t length, off_t offset)
+{
+    while (length) {
+        ssize_t done = pwrite(fd, buffer, length, offset);
+        if (done <= 0) {
+            return false;
+        }
+        buffer += done;
+        length -= done;
+        offset += done;
+    }
+    return true;
+}
+
+//exchange the non-overlapping byte ranges [first, first + length) and [second, second + length)
+static bool swap_file_blocks(int fd, off_t first, off_t second, off_t length,
+                             char *buffer, char *other, size_t block_size)
+{
+    for (off_t done = 0; done < length; done += block_size) {
+        size_t count = (length - done < (off_t)block_size) ? length - done : block_size;
+
+        if (!read_all(fd, buffer, count, first + done) || !read_all(fd, other, count, second + done)
+                || !write_all(fd, other, count, first + done) || !write_all(fd, buffer, count, second + done)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//move length bytes from from to to, chunk order safe for overlapping ranges
+static bool move_file_bytes(int fd, off_t from, off_t to, off_t length, char *buffer, size_t block_size)
+{
+    for (off_t done = 0; done < length; done += block_size) {
+        size_t count = (length - done < (off_t)block_size) ? length - done : block_size;
+        //copy forward when moving down, backward when moving up
+        off_t offset = (to < from) ? done : length - done - count;
+
+        if (!read_all(fd, buffer, count, from + offset) || !write_all(fd, buffer, count, to + offset)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Move [begin, begin + left + right) to the left by left bytes, the shorter
+ * part is kept in saved meanwhile.
+ */
+static bool rotate_file_buffered(int fd, off_t begin, off_t left, off_t right,
+                                 char *saved, char *buffer, size_t block_size)
+{
+    if (left <= right) {
+        return read_all(fd, saved, left, begin)
+                && move_file_bytes(fd, begin + left, begin, right, buffer, block_size)
+                && write_all(fd, saved, left, begin + right);
+    }
+    return read_all(fd, saved, right, begin + left)
+            && move_file_bytes(fd, begin, begin + right, left, buffer, block_size)
+            && write_all(fd, saved, right, begin);
+}
+
+bool rotate_file_blocks(const string &path, size_t record_size, long long k, size_t block_size)
+{
+    off_t size;
+    off_t shift;
+    int fd = open_for_rotate(path, record_size, k, size, shift);
+
+    if (fd < 0) {
+        return false;
+    }
+    if (!shift) {
+        close(fd);
+        return true;
+    }
+
+    vector<char> saved(block_size);
+    vector<char> buffer(block_size);
+    //the same Gries-Mills loop as rotate_trivial, over file offsets
+    off_t middle = size - shift;
+    off_t i = middle;
+    off_t j = shift;
+    bool ok = true;
+
+    while (ok && i && j) {
+        if (i <= (off_t)block_size || j <= (off_t)block_size) {
+            ok = rotate_file_buffered(fd, middle - i, i, j, &saved[0], &buffer[0], block_size);
+            break;
+        }
+        if (i < j) {
+            ok = swap_file_blocks(fd, middle - i, middle + j - i, i, &saved[0], &buffer[0], block_size);
+            j -= i;
+        } else {
+            ok = swap_file_blocks(fd, middle - i, middle, j, &saved[0], &buffer[0], block_size);
+            i -= j;
+        }
+    }
+
+    ok = !fsync(fd) && ok;
+    close(fd);
+    return ok;
+}
@@ -0,0 +1,25 @@
+#ifndef FILE_ROTATE_H
+#define FILE_ROTATE_H
+
+#include <cstddef>
+#include <string>
+
+/*
+ * Cyclic shift of a file of fixed size records to the right by k records,
+ * in place. Both return false if the file cannot be opened, mapped,
+ * read or written, or its size is not a multiple of record_size.
+ */
+
+//maps the file and runs rotate_trivial over its bytes
+bool rotate_file(const std::string &path, size_t record_size, long long k);
+
+/*
+ * pread/pwrite version for files that should not be mapped: Gries-Mills
+ * block swaps in block_size pieces until the shorter part fits block_size,
+ * then one buffered pass. Reads and writes every byte about once and
+ * needs 2 * block_size bytes of memory.
+ */
+bool rotate_file_blocks(const std::string &path, size_t record_size, long long k,
+                        size_t block_size = 64 << 20);
+
+#endif // FILE_ROTATE_H
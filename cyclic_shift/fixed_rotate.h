@@ -0,0 +1,185 @@
+#ifndef FIXED_ROTATE_H
+#define FIXED_ROTATE_H
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FIXED_ROTATE_PERMUTE
+#include <immintrin.h>
+#endif
+
+/*
+ * Rotation of short windows whose length N is a compile-time constant:
+ * rotate<N>(window, k) shifts [window, window + N) to the right by k.
+ * Windows of 16, 32 or 64 bytes of trivially copyable elements are rotated
+ * in registers on x86: a byte shuffle for 16 bytes (SSSE3), a permute of
+ * one ymm register for 32 bytes and of two for 64 bytes (AVX2). The
+ * kernels are compiled for their instruction set whatever the build flags
+ * and picked at run time when the CPU supports it. Other windows, and all
+ * windows on CPUs without it, take an unrolled copy through a local array.
+ */
+
+template <std::size_t N, typename T>
+void rotate_window(T *window, std::size_t k, std::false_type)
+{
+    T rotated[N];
+
+    for (std::size_t i = 0; i < k; ++i) {
+        rotated[i] = std::move(window[i + N - k]);
+    }
+    for (std::size_t i = k; i < N; ++i) {
+        rotated[i] = std::move(window[i - k]);
+    }
+    for (std::size_t i = 0; i < N; ++i) {
+        window[i] = std::move(rotated[i]);
+    }
+}
+
+#ifdef FIXED_ROTATE_PERMUTE
+//whether the CPU runs the register kernel for windows of bytes bytes
+inline bool window_permute_supported(std::size_t bytes)
+{
+    static const bool ssse3 = (__builtin_cpu_init(), __builtin_cpu_supports("ssse3"));
+    static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+
+    return (16 == bytes) ? ssse3 : avx2;
+}
+
+//byte i of the window takes byte (i - shift) mod 16
+__attribute__((target("ssse3")))
+inline void permute_window16(void *window, unsigned shift)
+{
+    __m128i bytes = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i index = _mm_and_si128(_mm_sub_epi8(bytes, _mm_set1_epi8((char)shift)), _mm_set1_epi8(15));
+
+    __m128i value = _mm_loadu_si128(static_cast<const __m128i *>(window));
+    _mm_storeu_si128(static_cast<__m128i *>(window), _mm_shuffle_epi8(value, index));
+}
+
+//value with byte i taken from byte (i - shift) mod 32, shift < 32
+__attribute__((target("avx2")))
+inline __m256i rotate_bytes32(__m256i value, unsigned shift)
+{
+    if (0 == shift % 4) {
+        __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        __m256i index = _mm256_and_si256(_mm256_sub_epi32(lanes, _mm256_set1_epi32(shift / 4)),
+                                         _mm256_set1_epi32(7));
+        return _mm256_permutevar8x32_epi32(value, index);
+    }
+
+    //_mm256_shuffle_epi8 stays inside 128-bit halves: bytes coming from the
+    //other half are shuffled out of value with its halves swapped, index
+    //bytes with the high bit set give zero in the shuffle not taking them
+    __m256i bytes = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                     16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+    __m256i source = _mm256_and_si256(_mm256_sub_epi8(bytes, _mm256_set1_epi8((char)shift)),
+                                      _mm256_set1_epi8(31));
+    __m256i crossing = _mm256_and_si256(_mm256_xor_si256(source, bytes), _mm256_set1_epi8(16));
+    __m256i same_half = _mm256_cmpeq_epi8(crossing, _mm256_setzero_si256());
+    __m256i index = _mm256_and_si256(source, _mm256_set1_epi8(15));
+    __m256i zero = _mm256_set1_epi8((char)0x80);
+
+    __m256i own = _mm256_shuffle_epi8(value, _mm256_or_si256(index, _mm256_andnot_si256(same_half, zero)));
+    __m256i swapped = _mm256_permute2x128_si256(value, value, 0x01);
+    __m256i other = _mm256_shuffle_epi8(swapped, _mm256_or_si256(index, _mm256_and_si256(same_half, zero)));
+    return _mm256_or_si256(own, other);
+}
+
+__attribute__((target("avx2")))
+inline void permute_window32(void *window, unsigned shift)
+{
+    __m256i value = _mm256_loadu_si256(static_cast<const __m256i *>(window));
+    _mm256_storeu_si256(static_cast<__m256i *>(window), rotate_bytes32(value, shift));
+}
+
+//both halves rotated by shift mod 32, the first shift bytes of each then come from the other one
+__attribute__((target("avx2")))
+inline void permute_window64(void *window, unsigned shift)
+{
+    __m256i *halves = static_cast<__m256i *>(window);
+    __m256i low = _mm256_loadu_si256(halves);
+    __m256i high = _mm256_loadu_si256(halves + 1);
+
+    if (shift >= 32) {
+        __m256i swapped = low;
+        low = high;
+        high = swapped;
+        shift -= 32;
+    }
+    low = rotate_bytes32(low, shift);
+    high = rotate_bytes32(high, shift);
+
+    __m256i bytes = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                     16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31);
+    __m256i wrapped = _mm256_cmpgt_epi8(_mm256_set1_epi8((char)shift), bytes);
+    _mm256_storeu_si256(halves, _mm256_blendv_epi8(low, high, wrapped));
+    _mm256_storeu_si256(halves + 1, _mm256_blendv_epi8(high, low, wrapped));
+}
+
+//rotate the bytes [window, window + bytes) to the right by shift, 0 < shift < bytes
+inline void permute_window(void *window, std::size_t bytes, std::size_t shift)
+{
+    if (16 == bytes) {
+        permute_window16(window, shift);
+    } else if (32 == bytes) {
+        permute_window32(window, shift);
+    } else {
+        permute_window64(window, shift);
+    }
+}
+
+template <std::size_t N, typename T>
+void rotate_window(T *window, std::size_t k, std::true_type)
+{
+    if (window_permute_supported(N * sizeof(T))) {
+        permute_window(window, N * sizeof(T), k * sizeof(T));
+    } else {
+        rotate_window<N>(window, k, std::false_type());
+    }
+}
+#endif
+
+//whether rotate<N> of T may take a register kernel
+template <std::size_t N, typename T>
+struct IsPermutable : std::integral_constant<bool,
+#ifdef FIXED_ROTATE_PERMUTE
+        std::is_trivially_copyable<T>::value
+        && (N * sizeof(T) == 16 || N * sizeof(T) == 32 || N * sizeof(T) == 64)
+#else
+        false
+#endif
+        > {};
+
+/*
+ * Shift [window, window + N) to the right by k positions,
+ * k may be negative or exceed N.
+ */
+template <std::size_t N, typename T> void rotate(T *window, std::ptrdiff_t k)
+{
+    k %= (std::ptrdiff_t)N;
+    if (k < 0) {
+        k += N;
+    }
+    if (0 == k) {
+        return;
+    }
+
+    rotate_window<N>(window, k, IsPermutable<N, T>());
+}
+
+/*
+ * Rotate count consecutive windows of N elements starting at windows,
+ * window i to the right by shifts[i].
+ */
+template <std::size_t N, typename T>
+void rotate_batch(T *windows, std::size_t count, const std::ptrdiff_t *shifts)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        rotate<N>(windows + i * N, shifts[i]);
+    }
+}
+
+#endif // FIXED_ROTATE_H
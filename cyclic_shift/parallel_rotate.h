@@ -0,0 +1,100 @@
+#ifndef PARALLEL_ROTATE_H
+#define PARALLEL_ROTATE_H
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "cyclic_shift.h"
+
+//shorter ranges are not worth starting threads for
+const std::ptrdiff_t PARALLEL_ROTATE_MIN_LENGTH = 1 << 20;
+
+//part of reversing [begin, begin + length): swap begin[i] and begin[length - 1 - i] for i in [from, to)
+template <typename T> void reverse_part(T begin, std::ptrdiff_t length, std::ptrdiff_t from, std::ptrdiff_t to)
+{
+    for (std::ptrdiff_t i = from; i < to; ++i) {
+        swap(begin[i], begin[length - 1 - i]);
+    }
+}
+
+/*
+ * Reverse the ranges [begins[r], begins[r] + lengths[r]) together,
+ * splitting all their swaps evenly over threads, inline for threads < 2.
+ */
+template <typename T> void parallel_reverse(const T *begins, const std::ptrdiff_t *lengths, int ranges, unsigned threads)
+{
+    if (threads < 2) {
+        for (int r = 0; r < ranges; ++r) {
+            reverse_part(begins[r], lengths[r], 0, lengths[r] / 2);
+        }
+        return;
+    }
+
+    std::ptrdiff_t total = 0;
+    for (int r = 0; r < ranges; ++r) {
+        total += lengths[r] / 2;
+    }
+
+    std::vector<std::thread> workers;
+    std::ptrdiff_t share = (total + threads - 1) / threads;
+    std::ptrdiff_t skipped = 0;
+    int r = 0;
+
+    //every worker gets share swaps, possibly spanning two ranges
+    for (unsigned t = 0; t < threads; ++t) {
+        std::ptrdiff_t first = t * share;
+        std::ptrdiff_t last = (t + 1) * share < total ? (t + 1) * share : total;
+
+        for (std::ptrdiff_t position = first; position < last; ) {
+            while (position - skipped >= lengths[r] / 2) {
+                skipped += lengths[r] / 2;
+                ++r;
+            }
+            std::ptrdiff_t end = skipped + lengths[r] / 2 < last ? skipped + lengths[r] / 2 : last;
+            workers.push_back(std::thread(reverse_part<T>, begins[r], lengths[r],
+                                          position - skipped, end - skipped));
+            position = end;
+        }
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+}
+
+/*
+ * rotate for arrays larger than the caches: three reversals, each one
+ * spread over threads (hardware_concurrency() if 0). Works in place.
+ * Shifts [begin, end] (end inclusive) to the right by k.
+ */
+template <typename T> void parallel_rotate(T begin, T end, std::ptrdiff_t k, unsigned threads = 0)
+{
+    std::ptrdiff_t length = end - begin + 1;
+
+    k %= length;
+    if (k < 0) {
+        k += length;
+    }
+    if (0 == k) {
+        return;
+    }
+    //hardware_concurrency() is a system call, not worth it for short ranges, and may return 0
+    if (!threads && length >= PARALLEL_ROTATE_MIN_LENGTH) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (length <= INT_MAX && (threads < 2 || length < PARALLEL_ROTATE_MIN_LENGTH)) {
+        rotate(begin, end, (int)k);
+        return;
+    }
+
+    //(AB)' = B'A': reverse both parts, then everything
+    T begins[] = {begin, begin + (length - k)};
+    std::ptrdiff_t lengths[] = {length - k, k};
+    parallel_reverse(begins, lengths, 2, threads);
+    parallel_reverse(begins, &length, 1, threads);
+}
+
+#endif // PARALLEL_ROTATE_H
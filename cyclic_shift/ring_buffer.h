@@ -0,0 +1,184 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "cyclic_shift.h"
+
+/*
+ * Circular buffer growing by doubling. rotate(k) is O(1): it only records
+ * a pending shift. push and pop at both ends are O(1) amortized, except
+ * that the first one after rotations of a non-full buffer applies the
+ * pending shift k with min(k, size - k) element moves; a full buffer
+ * applies it by moving the head. The elements are made contiguous in
+ * memory only when linearize() asks for it.
+ */
+template <typename T> class RingBuffer
+{
+private:
+    std::vector<T> buffer_;
+    //physical index of the first stored element
+    std::size_t head_;
+    std::size_t size_;
+    //pending right shift of the stored sequence, in [0, size_)
+    std::size_t shift_;
+
+    std::size_t physical(std::size_t i) const
+    {
+        std::size_t index = head_ + i;
+        return (index >= buffer_.size()) ? index - buffer_.size() : index;
+    }
+    void store_back(T value)
+    {
+        buffer_[physical(size_)] = std::move(value);
+        ++size_;
+    }
+    void store_front(T value)
+    {
+        head_ = (head_ ? head_ : buffer_.size()) - 1;
+        buffer_[head_] = std::move(value);
+        ++size_;
+    }
+    T take_back()
+    {
+        --size_;
+        T value = std::move(buffer_[physical(size_)]);
+        buffer_[physical(size_)] = T();
+        return value;
+    }
+    T take_front()
+    {
+        T value = std::move(buffer_[head_]);
+        buffer_[head_] = T();
+        head_ = physical(1);
+        --size_;
+        return value;
+    }
+    //apply the pending shift to the stored sequence
+    void normalize()
+    {
+        if (!shift_) {
+            return;
+        }
+        if (size_ == buffer_.size()) {
+            head_ = physical(size_ - shift_);
+        } else if (shift_ <= size_ / 2) {
+            for (std::size_t i = 0; i < shift_; ++i) {
+                store_front(take_back());
+            }
+        } else {
+            for (std::size_t i = shift_; i < size_; ++i) {
+                store_back(take_front());
+            }
+        }
+        shift_ = 0;
+    }
+    void reserve_one()
+    {
+        normalize();
+        if (size_ == buffer_.size()) {
+            linearize();
+            buffer_.resize(buffer_.empty() ? 16 : buffer_.size() * 2);
+        }
+    }
+
+public:
+    explicit RingBuffer(std::size_t capacity = 16):
+        buffer_(capacity),
+        head_(0),
+        size_(0),
+        shift_(0)
+    {
+    }
+
+    void push_back(const T &value)
+    {
+        reserve_one();
+        store_back(value);
+    }
+    void push_front(const T &value)
+    {
+        reserve_one();
+        store_front(value);
+    }
+    void pop_back()
+    {
+        normalize();
+        take_back();
+    }
+    void pop_front()
+    {
+        normalize();
+        take_front();
+    }
+
+    //shift the elements to the right by k positions, k may be negative or exceed the size
+    void rotate(std::ptrdiff_t k)
+    {
+        if (!size_) {
+            return;
+        }
+        std::ptrdiff_t length = size_;
+        k %= length;
+        if (k < 0) {
+            k += length;
+        }
+        shift_ = (shift_ + k) % size_;
+    }
+
+    /*
+     * Make the elements contiguous in memory in logical order and return
+     * the first one; a single in-place rotate of the storage when they wrap.
+     */
+    T *linearize()
+    {
+        normalize();
+        if (head_ + size_ > buffer_.size()) {
+            cyclic_shift(buffer_.begin(), buffer_.end(), -(std::ptrdiff_t)head_);
+            head_ = 0;
+        }
+        return buffer_.empty() ? 0 : &buffer_[head_];
+    }
+
+    T &operator [](std::size_t i)
+    {
+        std::size_t stored = (i >= shift_) ? i - shift_ : i + size_ - shift_;
+        return buffer_[physical(stored)];
+    }
+    const T &operator [](std::size_t i) const
+    {
+        std::size_t stored = (i >= shift_) ? i - shift_ : i + size_ - shift_;
+        return buffer_[physical(stored)];
+    }
+    T &front()
+    {
+        return (*this)[0];
+    }
+    T &back()
+    {
+        return (*this)[size_ - 1];
+    }
+    std::size_t size() const
+    {
+        return size_;
+    }
+    bool empty() const
+    {
+        return !size_;
+    }
+    std::size_t capacity() const
+    {
+        return buffer_.size();
+    }
+    void clear()
+    {
+        buffer_.assign(buffer_.size(), T());
+        head_ = 0;
+        size_ = 0;
+        shift_ = 0;
+    }
+};
+
+#endif // RING_BUFFER_H
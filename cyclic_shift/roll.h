@@ -0,0 +1,107 @@
+#ifndef ROLL_H
+#define ROLL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "cyclic_shift.h"
+
+/*
+ * Circular shift of a row-major array with dimensions shape along every
+ * axis: element (i0, ..., in) moves to ((i0 + shifts[0]) mod shape[0], ...).
+ *
+ * Shifting along axis a is a rotation of each contiguous block of
+ * shape[a] * (product of the later dimensions) elements, so there is no
+ * strided access: rows move as whole blocks and column shifts of a matrix
+ * are one rotation of the entire buffer.
+ */
+
+//scale a shift along an axis of the given size to [0, size)
+inline std::ptrdiff_t roll_shift(std::ptrdiff_t shift, size_t size)
+{
+    std::ptrdiff_t k = shift % (std::ptrdiff_t)size;
+
+    return (k < 0) ? k + size : k;
+}
+
+//in place, one pass per shifted axis, scratch bounded by ROTATE_BUFFER_SIZE
+template <typename T>
+void roll(T *data, const std::vector<size_t> &shape, const std::vector<std::ptrdiff_t> &shifts)
+{
+    size_t total = 1;
+    for (size_t axis = 0; axis < shape.size(); ++axis) {
+        total *= shape[axis];
+    }
+    if (!total) {
+        return;
+    }
+
+    size_t outer = 1;
+    for (size_t axis = 0; axis < shape.size(); ++axis) {
+        size_t block = total / outer;
+        size_t inner = block / shape[axis];
+        std::ptrdiff_t k = roll_shift(shifts[axis], shape[axis]);
+
+        if (k) {
+            for (size_t o = 0; o < outer; ++o) {
+                cyclic_shift(data + o * block, data + (o + 1) * block, k * inner);
+            }
+        }
+        outer *= shape[axis];
+    }
+}
+
+//out of place, a single pass: every row is copied as two contiguous pieces
+template <typename T>
+void roll_copy(const T *input, T *output, const std::vector<size_t> &shape,
+               const std::vector<std::ptrdiff_t> &shifts)
+{
+    size_t dimensions = shape.size();
+    if (!dimensions) {
+        return;
+    }
+
+    size_t row = shape[dimensions - 1];
+    size_t rows = 1;
+    for (size_t axis = 0; axis + 1 < dimensions; ++axis) {
+        rows *= shape[axis];
+    }
+    if (!row || !rows) {
+        return;
+    }
+
+    std::ptrdiff_t k = roll_shift(shifts[dimensions - 1], row);
+    //index of the current source row and of its destination along the outer axes
+    std::vector<size_t> index(dimensions - 1, 0);
+    std::vector<size_t> target(dimensions - 1);
+    for (size_t axis = 0; axis + 1 < dimensions; ++axis) {
+        target[axis] = roll_shift(shifts[axis], shape[axis]);
+    }
+
+    for (size_t r = 0; r < rows; ++r) {
+        size_t destination = 0;
+        for (size_t axis = 0; axis + 1 < dimensions; ++axis) {
+            destination = destination * shape[axis] + target[axis];
+        }
+
+        const T *from = input + r * row;
+        T *to = output + destination * row;
+        std::copy(from, from + row - k, to + k);
+        std::copy(from + row - k, from + row, to);
+
+        //next source row, destinations wrap around independently
+        for (size_t axis = dimensions - 1; axis-- > 0; ) {
+            ++index[axis];
+            if (++target[axis] == shape[axis]) {
+                target[axis] = 0;
+            }
+            if (index[axis] < shape[axis]) {
+                break;
+            }
+            index[axis] = 0;
+        }
+    }
+}
+
+#endif // ROLL_H
@@ -0,0 +1,195 @@
+#ifndef ROTATED_VIEW_H
+#define ROTATED_VIEW_H
+
+#include <cstddef>
+#include <iterator>
+
+#include "cyclic_shift.h"
+
+/*
+ * Non-owning view of the random access range [first, last) shifted to the
+ * right by k, i.e. view[i] == first[(i - k) mod length]. Shifting the view
+ * is O(1); the underlying range is rotated only by materialize().
+ */
+template <typename T> class RotatedView
+{
+public:
+    typedef typename std::iterator_traits<T>::value_type value_type;
+    typedef typename std::iterator_traits<T>::reference reference;
+    typedef typename std::iterator_traits<T>::pointer pointer;
+    typedef std::ptrdiff_t difference_type;
+
+    class iterator {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef typename RotatedView::value_type value_type;
+        typedef typename RotatedView::reference reference;
+        typedef typename RotatedView::pointer pointer;
+        typedef typename RotatedView::difference_type difference_type;
+    private:
+        T first_;
+        difference_type length_;
+        //underlying index of view element 0
+        difference_type start_;
+        difference_type index_;
+    public:
+
+        iterator(): first_(), length_(0), start_(0), index_(0) {}
+        iterator(T first, difference_type length, difference_type start, difference_type index):
+            first_(first),
+            length_(length),
+            start_(start),
+            index_(index)
+        {
+        }
+        reference operator *() const
+        {
+            difference_type position = start_ + index_;
+            return first_[(position >= length_) ? position - length_ : position];
+        }
+        pointer operator ->() const
+        {
+            return &**this;
+        }
+        reference operator [](difference_type n) const
+        {
+            return *(*this + n);
+        }
+        iterator &operator ++()
+        {
+            ++index_;
+            return *this;
+        }
+        iterator operator ++(int)
+        {
+            iterator old(*this);
+            ++index_;
+            return old;
+        }
+        iterator &operator --()
+        {
+            --index_;
+            return *this;
+        }
+        iterator operator --(int)
+        {
+            iterator old(*this);
+            --index_;
+            return old;
+        }
+        iterator &operator +=(difference_type n)
+        {
+            index_ += n;
+            return *this;
+        }
+        iterator &operator -=(difference_type n)
+        {
+            index_ -= n;
+            return *this;
+        }
+        iterator operator +(difference_type n) const
+        {
+            return iterator(first_, length_, start_, index_ + n);
+        }
+        iterator operator -(difference_type n) const
+        {
+            return iterator(first_, length_, start_, index_ - n);
+        }
+        friend iterator operator +(difference_type n, const iterator &it)
+        {
+            return it + n;
+        }
+        difference_type operator -(const iterator &other) const
+        {
+            return index_ - other.index_;
+        }
+        bool operator ==(const iterator &other) const
+        {
+            return index_ == other.index_;
+        }
+        bool operator !=(const iterator &other) const
+        {
+            return index_ != other.index_;
+        }
+        bool operator <(const iterator &other) const
+        {
+            return index_ < other.index_;
+        }
+        bool operator >(const iterator &other) const
+        {
+            return index_ > other.index_;
+        }
+        bool operator <=(const iterator &other) const
+        {
+            return index_ <= other.index_;
+        }
+        bool operator >=(const iterator &other) const
+        {
+            return index_ >= other.index_;
+        }
+    };
+
+private:
+    T first_;
+    difference_type length_;
+    //current right shift, in [0, length_)
+    difference_type shift_;
+
+    difference_type start() const
+    {
+        return shift_ ? length_ - shift_ : 0;
+    }
+
+public:
+    RotatedView(T first, T last, difference_type k = 0):
+        first_(first),
+        length_(last - first),
+        shift_(0)
+    {
+        shift(k);
+    }
+
+    //shift the view further to the right by k, O(1)
+    void shift(difference_type k)
+    {
+        if (!length_) {
+            return;
+        }
+        shift_ = (shift_ + k % length_) % length_;
+        if (shift_ < 0) {
+            shift_ += length_;
+        }
+    }
+
+    //total shift not yet applied to the underlying range
+    difference_type pending() const
+    {
+        return shift_;
+    }
+
+    //rotate the underlying range so that it reads as the view, the view stays the same
+    void materialize()
+    {
+        cyclic_shift(first_, first_ + length_, shift_);
+        shift_ = 0;
+    }
+
+    difference_type size() const
+    {
+        return length_;
+    }
+    iterator begin() const
+    {
+        return iterator(first_, length_, start(), 0);
+    }
+    iterator end() const
+    {
+        return iterator(first_, length_, start(), length_);
+    }
+    reference operator [](difference_type i) const
+    {
+        return begin()[i];
+    }
+};
+
+#endif // ROTATED_VIEW_H
@@ -0,0 +1,411 @@
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+using std::vector;
+
+/*
+ * Convolution engine for long polynomial products: a complex FFT for float
+ * and double coefficients and a number theoretic transform modulo three
+ * primes, recombined by CRT, for integer coefficients.
+ * convolve() returns false when it cannot do the product exactly or
+ * accurately enough, the caller then falls back to Karatsuba.
+ */
+
+//shorter operands are cheaper to multiply by Karatsuba
+const size_t FFT_THRESHOLD = 256;
+const size_t NTT_THRESHOLD = 4096;
+
+typedef std::complex<double> Complex;
+
+inline size_t transform_size(size_t size)
+{
+    size_t n = 1;
+    while (n < size) {
+        n <<= 1;
+    }
+    return n;
+}
+
+//e^(2 pi i j / n) for j < n / 2, computed directly rather than by repeated products to keep the error at O(eps log n)
+inline vector<Complex> fft_roots(size_t n)
+{
+    vector<Complex> roots(n / 2);
+    const double pi = std::acos(-1.0);
+
+    for (size_t j = 0; j < n / 2; ++j) {
+        double angle = 2 * pi * j / n;
+        roots[j] = Complex(std::cos(angle), std::sin(angle));
+    }
+    return roots;
+}
+
+//std::complex multiplication checks for infinities and NaN through a library call
+inline Complex multiply(const Complex &a, const Complex &b)
+{
+    return Complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+/*
+ * In place iterative radix-2 FFT of length n, a power of two, roots from
+ * fft_roots(n); the inverse is without the 1/n factor.
+ */
+inline void fft(Complex *a, size_t n, const Complex *roots, bool inverse)
+{
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(a[i], a[j]);
+        }
+    }
+
+    for (size_t length = 2; length <= n; length <<= 1) {
+        size_t half = length / 2;
+        size_t stride = n / length;
+        for (size_t start = 0; start < n; start += length) {
+            for (size_t j = 0; j < half; ++j) {
+                Complex root = inverse ? std::conj(roots[j * stride]) : roots[j * stride];
+                Complex u = a[start + j];
+                Complex v = multiply(a[start + j + half], root);
+                a[start + j] = u + v;
+                a[start + j + half] = u - v;
+            }
+        }
+    }
+}
+
+//binary exponent of max |a[i]|, 0 for a zero operand
+template <class T> int max_exponent(const T *a, size_t size)
+{
+    double largest = 0;
+    for (size_t i = 0; i < size; ++i) {
+        largest = std::max(largest, std::fabs(double(a[i])));
+    }
+    int exponent = 0;
+    std::frexp(largest, &exponent);
+    return exponent;
+}
+
+/*
+ * out[0, a_size + b_size - 1) += a * b through one complex FFT pair of
+ * length n: a in the real and b in the imaginary part,
+ * A * B = (C[j]^2 - conj(C[-j])^2) / 4i.
+ * The packed error grows with max|a|^2 + max|b|^2, so b is first scaled by
+ * a power of two to the magnitude of a, which is exact, and the product
+ * is scaled back.
+ */
+template <class T> void fft_product(const T *a, size_t a_size, const T *b, size_t b_size,
+                                    size_t n, const Complex *roots, T *out)
+{
+    vector<Complex> c(n);
+    int a_exponent = max_exponent(a, a_size);
+    int b_exponent = max_exponent(b, b_size);
+    int shift = (a_exponent && b_exponent) ? a_exponent - b_exponent : 0;
+
+    for (size_t i = 0; i < a_size; ++i) {
+        c[i].real(a[i]);
+    }
+    for (size_t i = 0; i < b_size; ++i) {
+        c[i].imag(std::ldexp(double(b[i]), shift));
+    }
+    fft(&c[0], n, roots, false);
+
+    vector<Complex> product(n);
+    for (size_t j = 0; j < n; ++j) {
+        Complex x = c[j];
+        Complex y = std::conj(c[(n - j) & (n - 1)]);
+        product[j] = multiply(multiply(x, x) - multiply(y, y), Complex(0, -0.25));
+    }
+    fft(&product[0], n, roots, true);
+
+    for (size_t i = 0; i < a_size + b_size - 1; ++i) {
+        out[i] += T(std::ldexp(product[i].real() / n, -shift));
+    }
+}
+
+/*
+ * Floating point product. With both operands of the same magnitude the FFT
+ * error of a coefficient is O(eps log n) times ||a|| ||b||, so the longer
+ * operand is split into pieces the size of the shorter one: the error stays
+ * within a log factor of the schoolbook bound b_size * eps * max|a| * max|b|,
+ * however unbalanced the operands are in length or magnitude.
+ */
+template <class T> bool convolve_fft(const T *a, size_t a_size, const T *b, size_t b_size, T *out)
+{
+    if (a_size < b_size) {
+        std::swap(a, b);
+        std::swap(a_size, b_size);
+    }
+    if (b_size < FFT_THRESHOLD) {
+        return false;
+    }
+
+    size_t n = transform_size(2 * b_size - 1);
+    vector<Complex> roots = fft_roots(n);
+
+    std::fill(out, out + a_size + b_size - 1, T(0));
+    for (size_t start = 0; start < a_size; start += b_size) {
+        fft_product(a + start, std::min(b_size, a_size - start), b, b_size, n, &roots[0], out + start);
+    }
+    return true;
+}
+
+#ifdef __SIZEOF_INT128__
+template <uint32_t P> uint32_t power_mod(uint32_t base, uint64_t exponent)
+{
+    uint64_t result = 1;
+    uint64_t value = base;
+
+    for (; exponent; exponent >>= 1) {
+        if (exponent & 1) {
+            result = result * value % P;
+        }
+        value = value * value % P;
+    }
+    return (uint32_t)result;
+}
+
+/*
+ * Montgomery arithmetic modulo an odd P < 2^31 with R = 2^32: values are kept
+ * as x * R mod P, products are reduced with multiplications instead of a division.
+ */
+template <uint32_t P> struct Montgomery
+{
+    //-P^-1 mod 2^32 by Newton iteration, each step doubles the correct bits
+    static constexpr uint32_t negative_inverse(uint32_t x = P, int steps = 5)
+    {
+        return steps ? negative_inverse(x * (2 - P * x), steps - 1) : 0u - x;
+    }
+    static uint32_t reduce(uint64_t t)
+    {
+        uint32_t m = (uint32_t)t * negative_inverse();
+        uint32_t u = (uint32_t)((t + (uint64_t)m * P) >> 32);
+        return correct(u - P);
+    }
+    //x + P if x, an element of (-P, P) as two's complement, is negative; branchless
+    static uint32_t correct(uint32_t x)
+    {
+        return x + (P & (0u - (x >> 31)));
+    }
+    static uint32_t multiply(uint32_t a, uint32_t b)
+    {
+        return reduce((uint64_t)a * b);
+    }
+    static uint32_t from(uint32_t x)
+    {
+        //R^2 mod P
+        static const uint32_t r2 = (uint32_t)(((unsigned __int128)1 << 64) % P);
+        return multiply(x, r2);
+    }
+    static uint32_t to(uint32_t x)
+    {
+        return reduce(x);
+    }
+};
+
+/*
+ * Roots of unity modulo P in Montgomery form for every stage of a length n
+ * transform, stage length l at [l / 2, l): w_l^j for j < l / 2, inverted
+ * for the inverse transform. Contiguous per stage for the butterfly loop.
+ */
+template <uint32_t P, uint32_t G> vector<uint32_t> ntt_roots(size_t n, bool inverse)
+{
+    typedef Montgomery<P> M;
+    vector<uint32_t> roots(std::max(n, size_t(2)));
+
+    for (size_t length = 2; length <= n; length <<= 1) {
+        uint32_t root = power_mod<P>(G, (P - 1) / length);
+        if (inverse) {
+            root = power_mod<P>(root, P - 2);
+        }
+        root = M::from(root);
+
+        uint32_t *stage = &roots[length / 2];
+        stage[0] = M::from(1);
+        for (size_t j = 1; j < length / 2; ++j) {
+            stage[j] = M::multiply(stage[j - 1], root);
+        }
+    }
+    return roots;
+}
+
+//NTT modulo the prime P of length n on values in Montgomery form, roots from ntt_roots(n)
+template <uint32_t P> void ntt(uint32_t *a, size_t n, const uint32_t *roots)
+{
+    typedef Montgomery<P> M;
+
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(a[i], a[j]);
+        }
+    }
+
+    for (size_t length = 2; length <= n; length <<= 1) {
+        size_t half = length / 2;
+        const uint32_t *stage = roots + half;
+        for (size_t start = 0; start < n; start += length) {
+            uint32_t *low = a + start;
+            uint32_t *high = low + half;
+            for (size_t j = 0; j < half; ++j) {
+                uint32_t u = low[j];
+                uint32_t v = M::multiply(high[j], stage[j]);
+                low[j] = M::correct(u + v - P);
+                high[j] = M::correct(u - v);
+            }
+        }
+    }
+}
+
+//value mod P in [0, P), in 64 bit arithmetic
+template <uint32_t P, class T> uint32_t residue(T value)
+{
+    if (std::is_signed<T>::value) {
+        long long r = (long long)value % (long long)P;
+        return (uint32_t)(r < 0 ? r + P : r);
+    }
+    return (uint32_t)((unsigned long long)value % P);
+}
+
+//the exact product modulo P into residues[0, n), n a power of two
+template <uint32_t P, uint32_t G, class T>
+void ntt_product(const T *a, size_t a_size, const T *b, size_t b_size, size_t n, uint32_t *residues)
+{
+    typedef Montgomery<P> M;
+    vector<uint32_t> other(n, 0);
+
+    std::fill(residues, residues + n, 0);
+    for (size_t i = 0; i < a_size; ++i) {
+        residues[i] = M::from(residue<P>(a[i]));
+    }
+    for (size_t i = 0; i < b_size; ++i) {
+        other[i] = M::from(residue<P>(b[i]));
+    }
+    vector<uint32_t> roots = ntt_roots<P, G>(n, false);
+    ntt<P>(residues, n, &roots[0]);
+    ntt<P>(&other[0], n, &roots[0]);
+    for (size_t i = 0; i < n; ++i) {
+        residues[i] = M::multiply(residues[i], other[i]);
+    }
+    roots = ntt_roots<P, G>(n, true);
+    ntt<P>(residues, n, &roots[0]);
+
+    uint32_t n_inverse = M::from(power_mod<P>((uint32_t)(n % P), P - 2));
+    for (size_t i = 0; i < n; ++i) {
+        residues[i] = M::to(M::multiply(residues[i], n_inverse));
+    }
+}
+
+//primes k * 2^s + 1 with s >= 26: transforms up to 2^26 long, product about 2^90
+const uint32_t NTT_PRIME_1 = 2013265921;
+const uint32_t NTT_PRIME_2 = 1811939329;
+const uint32_t NTT_PRIME_3 = 469762049;
+const size_t NTT_MAX_SIZE = size_t(1) << 26;
+
+template <class T> double magnitude(const T *a, size_t size)
+{
+    double result = 0;
+    for (size_t i = 0; i < size; ++i) {
+        result = std::max(result, std::fabs((double)a[i]));
+    }
+    return result;
+}
+
+/*
+ * Integer product: exact while every coefficient of the true product is
+ * below half the product of the primes in magnitude, otherwise false.
+ * The result is then reduced like T arithmetic would wrap it.
+ */
+template <class T> bool convolve_ntt(const T *a, size_t a_size, const T *b, size_t b_size, T *out)
+{
+    size_t shorter = std::min(a_size, b_size);
+    size_t size = a_size + b_size - 1;
+    size_t n = transform_size(size);
+
+    if (shorter < NTT_THRESHOLD || n > NTT_MAX_SIZE) {
+        return false;
+    }
+    if (magnitude(a, a_size) * magnitude(b, b_size) * shorter >= std::ldexp(1.0, 88)) {
+        return false;
+    }
+
+    vector<uint32_t> r1(n), r2(n), r3(n);
+    ntt_product<NTT_PRIME_1, 31>(a, a_size, b, b_size, n, &r1[0]);
+    ntt_product<NTT_PRIME_2, 13>(a, a_size, b, b_size, n, &r2[0]);
+    ntt_product<NTT_PRIME_3, 3>(a, a_size, b, b_size, n, &r3[0]);
+
+    //Garner: x = r1 + p1 * (t2 + p2 * t3)
+    const uint64_t p1 = NTT_PRIME_1;
+    const uint64_t p2 = NTT_PRIME_2;
+    const uint64_t p3 = NTT_PRIME_3;
+    const uint64_t p1_inverse = power_mod<NTT_PRIME_2>(NTT_PRIME_1 % NTT_PRIME_2, p2 - 2);
+    const uint64_t p12_inverse = power_mod<NTT_PRIME_3>((uint32_t)(p1 * p2 % p3), p3 - 2);
+    const unsigned __int128 modulus = (unsigned __int128)(p1 * p2) * p3;
+
+    for (size_t i = 0; i < size; ++i) {
+        uint64_t t2 = (r2[i] + p2 - r1[i] % p2) % p2 * p1_inverse % p2;
+        uint64_t x12 = r1[i] + p1 * t2;
+        uint64_t t3 = (r3[i] + p3 - x12 % p3) % p3 * p12_inverse % p3;
+        unsigned __int128 x = x12 + (unsigned __int128)(p1 * p2) * t3;
+
+        out[i] = (x > modulus / 2) ? T(-(__int128)(modulus - x)) : T(x);
+    }
+    return true;
+}
+#endif
+
+template <class T> bool convolve(const T *, size_t, const T *, size_t, T *, std::false_type, std::false_type)
+{
+    return false;
+}
+
+template <class T> bool convolve(const T *a, size_t a_size, const T *b, size_t b_size, T *out,
+                                 std::true_type, std::false_type)
+{
+    return convolve_fft(a, a_size, b, b_size, out);
+}
+
+template <class T> bool convolve(const T *a, size_t a_size, const T *b, size_t b_size, T *out,
+                                 std::false_type, std::true_type)
+{
+#ifdef __SIZEOF_INT128__
+    return convolve_ntt(a, a_size, b, b_size, out);
+#else
+    (void)a; (void)a_size; (void)b; (void)b_size; (void)out;
+    return false;
+#endif
+}
+
+/*
+ * out[0, a_size + b_size - 1) = a * b by FFT for float and double,
+ * by NTT for integers up to 64 bits. false, with out untouched, when
+ * T has no fast path, the operands are too short or the NTT would not
+ * be exact.
+ */
+template <class T> bool convolve(const T *a, size_t a_size, const T *b, size_t b_size, T *out)
+{
+    typedef std::integral_constant<bool, std::is_same<T, double>::value
+            || std::is_same<T, float>::value> IsFloating;
+    typedef std::integral_constant<bool, std::is_integral<T>::value
+            && !std::is_same<T, bool>::value && sizeof(T) <= 8> IsInteger;
+
+    return convolve(a, a_size, b, b_size, out, IsFloating(), IsInteger());
+}
+
+#endif // CONVOLUTION_H
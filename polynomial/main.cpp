@@ -1,5 +1,7 @@
 #include "assert.h"
 
+#include <cmath>
+
 #include <vector>
 #include <sstream>
 #include <string>
@@ -9,6 +11,109 @@
 using std::string;
 using std::vector;
 
+//псевдослучайные коэффициенты из [-range, range]
+vector<int> random_coefficients(int size, int range, unsigned &seed)
+{
+    vector<int> result(size);
+    for (int i = 0; i < size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        result[i] = int((seed >> 16) % (2 * range + 1)) - range;
+    }
+    result[size - 1] = range;
+    return result;
+}
+
+//произведение многочленов "в столбик"
+template <class T> vector<T> naive_product(const vector<T> &a, const vector<T> &b)
+{
+    vector<T> result(a.size() + b.size() - 1, 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = 0; j < b.size(); ++j) {
+            result[i + j] += a[i] * b[j];
+        }
+    }
+    return result;
+}
+
+//вычеты по простому модулю: поле, в котором деление и НОД точные
+struct Modular {
+    static const long long P = 998244353;
+    long long value;
+
+    Modular(long long v = 0): value(((v % P) + P) % P) {}
+    Modular operator +(const Modular &other) const { return Modular(value + other.value); }
+    Modular operator -(const Modular &other) const { return Modular(value - other.value); }
+    Modular operator *(const Modular &other) const { return Modular(value * other.value); }
+    Modular operator /(const Modular &other) const
+    {
+        //other^(P - 2)
+        Modular result(1);
+        Modular base(other);
+        for (long long e = P - 2; e; e >>= 1) {
+            if (e & 1) {
+                result = result * base;
+            }
+            base = base * base;
+        }
+        return *this * result;
+    }
+    Modular &operator +=(const Modular &other) { return *this = *this + other; }
+    Modular &operator -=(const Modular &other) { return *this = *this - other; }
+    Modular &operator *=(const Modular &other) { return *this = *this * other; }
+    Modular &operator /=(const Modular &other) { return *this = *this / other; }
+    bool operator ==(const Modular &other) const { return value == other.value; }
+    bool operator !=(const Modular &other) const { return value != other.value; }
+    explicit operator bool() const { return value != 0; }
+};
+
+template <> struct IsExactField<Modular> : std::true_type {};
+
+Polynomial<Modular> random_modular(int size, unsigned &seed)
+{
+    vector<Modular> result(size);
+    for (int i = 0; i < size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        result[i] = Modular(seed >> 8);
+    }
+    result[size - 1] = 1;
+    return Polynomial<Modular>(result.begin(), --result.end());
+}
+
+//НОД g * u и g * v равен приведённому g при взаимно простых u и v, x * a + y * b == НОД
+void check_gcd(int g_size, int u_size, int v_size, unsigned &seed)
+{
+    Polynomial<Modular> g = random_modular(g_size, seed);
+    Polynomial<Modular> a = g * random_modular(u_size, seed);
+    Polynomial<Modular> b = g * random_modular(v_size, seed);
+    Polynomial<Modular> x(0), y(0);
+
+    assert(a.gcdex(b, x, y) == g);
+    assert(x * a + y * b == g);
+    assert(b.gcdex(a, x, y) == g);
+    assert(x * b + y * a == g);
+    assert((a, b) == g);
+    assert((b, a) == g);
+}
+
+//(a * b + r) / b == a, (a * b + r) % b == r для приведённого b
+template <class T> void check_division(int a_size, int b_size, int r_size, unsigned &seed)
+{
+    vector<int> a = random_coefficients(a_size, 5, seed);
+    vector<int> b = random_coefficients(b_size, 5, seed);
+    vector<int> r = random_coefficients(r_size, 5, seed);
+    b.back() = 1;
+
+    Polynomial<T> quotient = Polynomial<T>(a.begin(), --a.end());
+    Polynomial<T> divisor = Polynomial<T>(b.begin(), --b.end());
+    Polynomial<T> remainder = Polynomial<T>(r.begin(), --r.end());
+    Polynomial<T> dividend = quotient * divisor + remainder;
+    Polynomial<T> q(0), rest(0);
+
+    dividend.divmod(divisor, q, rest);
+    assert(q == quotient && rest == remainder);
+    assert(dividend / divisor == quotient && dividend % divisor == remainder);
+}
+
 int main()
 {
     /*
@@ -184,5 +289,207 @@ int main()
     assert((mult1 * mult2 * mult4, mult1 * mult3 * mult4) == mult1 * mult4);
     assert((mult1 * mult2,  mult3 * mult4) == 1);
 
+    /*
+     *10. Умножение многочленов высокой степени (алгоритм Карацубы)
+    */
+    unsigned seed = 1;
+    int sizes[][2] = {{33, 33}, {100, 100}, {1000, 999}, {1000, 40}, {77, 500}, {2048, 2048}};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        vector<int> a = random_coefficients(sizes[i][0], 10, seed);
+        vector<int> b = random_coefficients(sizes[i][1], 10, seed);
+        vector<int> c = naive_product(a, b);
+
+        Polynomial<int> product = Polynomial<int>(a.begin(), --a.end()) * Polynomial<int>(b.begin(), --b.end());
+        assert(product == Polynomial<int>(c.begin(), --c.end()));
+    }
+    //произведение на себя
+    polynom = Polynomial<int>(arr, &arr[3]);
+    other = polynom;
+    polynom *= polynom;
+    assert(polynom == other * other);
+
+    /*
+     *11. Умножение через БПФ (double) и теоретико-числовое преобразование (целые)
+    */
+    int ntt_sizes[][2] = {{4096, 4096}, {9000, 5001}, {30000, 4100}};
+    for (size_t i = 0; i < sizeof(ntt_sizes) / sizeof(ntt_sizes[0]); ++i) {
+        vector<int> a = random_coefficients(ntt_sizes[i][0], 100, seed);
+        vector<int> b = random_coefficients(ntt_sizes[i][1], 100, seed);
+        vector<int> c = naive_product(a, b);
+
+        Polynomial<int> product = Polynomial<int>(a.begin(), --a.end()) * Polynomial<int>(b.begin(), --b.end());
+        assert(product == Polynomial<int>(c.begin(), --c.end()));
+    }
+    //коэффициенты по модулю 2^64, как при обычном умножении
+    vector<unsigned long long> u_a(5000), u_b(4500);
+    for (size_t i = 0; i < u_a.size(); ++i) {
+        u_a[i] = (i * 2654435761ULL) % (1ULL << 30) + 1;
+    }
+    for (size_t i = 0; i < u_b.size(); ++i) {
+        u_b[i] = (i * 40503ULL) % (1ULL << 30) + 1;
+    }
+    vector<unsigned long long> u_c = naive_product(u_a, u_b);
+    Polynomial<unsigned long long> u_product = Polynomial<unsigned long long>(u_a.begin(), --u_a.end())
+            * Polynomial<unsigned long long>(u_b.begin(), --u_b.end());
+    assert(u_product == Polynomial<unsigned long long>(u_c.begin(), --u_c.end()));
+    //слишком большие коэффициенты: умножение Карацубой
+    u_a[7] = 1ULL << 63;
+    u_b[5] = 3ULL << 61;
+    u_c = naive_product(u_a, u_b);
+    u_product = Polynomial<unsigned long long>(u_a.begin(), --u_a.end())
+            * Polynomial<unsigned long long>(u_b.begin(), --u_b.end());
+    assert(u_product == Polynomial<unsigned long long>(u_c.begin(), --u_c.end()));
+
+    int fft_sizes[][2] = {{300, 300}, {4000, 4000}, {10000, 700}};
+    for (size_t i = 0; i < sizeof(fft_sizes) / sizeof(fft_sizes[0]); ++i) {
+        vector<double> a(fft_sizes[i][0]), b(fft_sizes[i][1]);
+        for (size_t j = 0; j < a.size(); ++j) {
+            a[j] = std::sin(j * 0.37) + 0.5;
+        }
+        for (size_t j = 0; j < b.size(); ++j) {
+            b[j] = std::cos(j * 1.13) - 0.25;
+        }
+        vector<double> c = naive_product(a, b);
+
+        Polynomial<double> product = Polynomial<double>(a.begin(), --a.end()) * Polynomial<double>(b.begin(), --b.end());
+        assert(product.Degree() == int(c.size()) - 1);
+        for (size_t j = 0; j < c.size(); ++j) {
+            assert(std::fabs(product[j] - c[j]) < 1e-9);
+        }
+    }
+    //множители очень разного масштаба: ошибка от max|a| max|b|, а не от max|a|^2
+    {
+        vector<double> a(1000), b(1000);
+        for (size_t j = 0; j < a.size(); ++j) {
+            a[j] = (std::sin(j * 0.37) + 0.5) * 1e8;
+            b[j] = (std::cos(j * 1.13) - 0.25) * 1e-8;
+        }
+        vector<double> c = naive_product(a, b);
+
+        Polynomial<double> product = Polynomial<double>(a.begin(), --a.end()) * Polynomial<double>(b.begin(), --b.end());
+        for (size_t j = 0; j < c.size(); ++j) {
+            assert(std::fabs(product[j] - c[j]) < 1e-9);
+        }
+    }
+
+    /*
+     *12. Деление с остатком: в столбик и итерациями Ньютона
+    */
+    //делитель со старшим коэффициентом 2: целочисленное деление коэффициентов
+    arr[0] = 0;
+    arr[1] = 4;
+    arr[2] = 2;
+    polynom = Polynomial<int>(arr, &arr[2]);
+    //polynom == 2x^2 + 4x
+    arr[0] = 0;
+    arr[1] = 2;
+    other = Polynomial<int>(arr, &arr[1]);
+    arr[0] = 2;
+    arr[1] = 1;
+    assert(polynom / other == Polynomial<int>(arr, &arr[1]));
+    assert(polynom % other == 0);
+    //x^2 / 2x: старший коэффициент не делится, остаток x^2
+    polynom = Polynomial<int>(0);
+    polynom[2] = 1;
+    assert(polynom / other == 0);
+    assert(polynom % other == polynom);
+
+    int division_sizes[][3] = {{50, 20, 10}, {3000, 500, 300}, {300, 2000, 1500}, {5000, 4000, 100}};
+    for (size_t i = 0; i < sizeof(division_sizes) / sizeof(division_sizes[0]); ++i) {
+        check_division<int>(division_sizes[i][0], division_sizes[i][1], division_sizes[i][2], seed);
+        check_division<unsigned>(division_sizes[i][0], division_sizes[i][1], division_sizes[i][2], seed);
+    }
+    for (size_t i = 0; i < sizeof(division_sizes) / sizeof(division_sizes[0]); ++i) {
+        vector<double> a(division_sizes[i][0]), b(division_sizes[i][1]), r(division_sizes[i][2]);
+        for (size_t j = 0; j < a.size(); ++j) {
+            a[j] = std::sin(j * 0.71);
+        }
+        for (size_t j = 0; j < b.size(); ++j) {
+            b[j] = std::cos(j * 0.3) / (j + 1);
+        }
+        b.back() = 2;
+        for (size_t j = 0; j < r.size(); ++j) {
+            r[j] = std::cos(j * 2.9) + 1;
+        }
+
+        Polynomial<double> divisor(b.begin(), --b.end());
+        Polynomial<double> dividend = Polynomial<double>(a.begin(), --a.end()) * divisor
+                + Polynomial<double>(r.begin(), --r.end());
+        Polynomial<double> q(0.0), rest(0.0);
+
+        dividend.divmod(divisor, q, rest);
+        for (size_t j = 0; j < a.size(); ++j) {
+            assert(std::fabs(q[j] - a[j]) < 1e-6);
+        }
+        for (size_t j = 0; j < r.size(); ++j) {
+            assert(std::fabs(rest[j] - r[j]) < 1e-6);
+        }
+        assert(rest.Degree() < divisor.Degree());
+    }
+
+    /*
+     *13. НОД с коэффициентами Безу: алгоритм Евклида и half-gcd
+    */
+    check_gcd(1, 1, 1, seed);
+    check_gcd(5, 10, 7, seed);
+    check_gcd(100, 100, 100, seed);
+    check_gcd(300, 400, 350, seed);
+    check_gcd(1, 2000, 1500, seed);
+    check_gcd(700, 1200, 1200, seed);
+    check_gcd(50, 1000, 3, seed);
+
+    Polynomial<Modular> zero(0), x(0), y(0);
+    Polynomial<Modular> m_polynom = random_modular(200, seed) * Modular(5);
+    Polynomial<Modular> monic = m_polynom / m_polynom[m_polynom.Degree()];
+    assert(m_polynom.gcdex(zero, x, y) == monic && x * m_polynom == monic && y.Degree() == -1);
+    assert(zero.gcdex(m_polynom, x, y) == monic && y * m_polynom == monic && x.Degree() == -1);
+    assert(zero.gcdex(zero, x, y).Degree() == -1 && x.Degree() == -1 && y.Degree() == -1);
+
+    Polynomial<double> d_x(0.0), d_y(0.0);
+    assert(mult1.gcdex(mult2, d_x, d_y) == 1.0);
+    assert(d_x * mult1 + d_y * mult2 == 1.0);
+
+    /*
+     *14. Значения многочлена в наборе точек
+    */
+    vector<int> points(1000);
+    vector<int> values(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        points[i] = int(i % 7) - 3;
+    }
+    polynom = Polynomial<int>(arr, &arr[1]) * Polynomial<int>(arr, &arr[1]) * 3 - 1;
+    polynom.evaluate(&points[0], points.size(), &values[0]);
+    for (size_t i = 0; i < points.size(); ++i) {
+        assert(values[i] == polynom(points[i]));
+    }
+    polynom.evaluate(&points[0], 7, &values[0], 4);
+    polynom.evaluate(&points[0], points.size(), &values[0], 3);
+    for (size_t i = 0; i < points.size(); ++i) {
+        assert(values[i] == polynom(points[i]));
+    }
+
+    //дерево произведений: поле вычетов и беззнаковые целые
+    Polynomial<Modular> m_big = random_modular(2000, seed);
+    vector<Modular> m_points(5000), m_values(5000);
+    for (size_t i = 0; i < m_points.size(); ++i) {
+        m_points[i] = Modular(i * i + 17);
+    }
+    m_big.evaluate(&m_points[0], m_points.size(), &m_values[0], 2);
+    for (size_t i = 0; i < m_points.size(); ++i) {
+        assert(m_values[i] == m_big(m_points[i]));
+    }
+
+    vector<unsigned> u_coefficients = vector<unsigned>(1500, 3);
+    u_coefficients[7] = 12345;
+    Polynomial<unsigned> u_big(u_coefficients.begin(), --u_coefficients.end());
+    vector<unsigned> u_points(2500), u_values(2500);
+    for (size_t i = 0; i < u_points.size(); ++i) {
+        u_points[i] = unsigned(i * 2654435761u);
+    }
+    u_big.evaluate(&u_points[0], u_points.size(), &u_values[0]);
+    for (size_t i = 0; i < u_points.size(); ++i) {
+        assert(u_values[i] == u_big(u_points[i]));
+    }
+
     return 0;
 }
@@ -1,19 +1,70 @@
 #ifndef POLYNOMIAL_H
 #define POLYNOMIAL_H
 
+#include <algorithm>
+#include <limits>
 #include <ostream>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "convolution.h"
+
 using std::ostream;
 using std::string;
 using std::vector;
 
+//operands with at most this many coefficients are multiplied by the schoolbook loop
+const size_t KARATSUBA_THRESHOLD = 32;
+//quotients and divisors at least this long are divided by Newton iteration
+const size_t NEWTON_DIVISION_THRESHOLD = 128;
+//gcd of polynomials of lower degree by the Euclidean algorithm, otherwise by half-gcd
+const int HALF_GCD_THRESHOLD = 128;
+//points evaluated together by one Horner pass, the inner loop vectorizes over them
+const size_t HORNER_BLOCK = 16;
+//degree and number of points from which evaluate() uses a subproduct tree
+const size_t SUBPRODUCT_THRESHOLD = 1024;
+//shorter batches are not worth starting threads for
+const size_t PARALLEL_EVALUATE_MIN_POINTS = 1 << 14;
+
+/*
+ * Coefficient types with exact field arithmetic, integers modulo a prime
+ * for example. Specialize as true for them: evaluate() then may use a
+ * subproduct tree, which is only accurate for exact types.
+ */
+template <class T> struct IsExactField : std::false_type {};
+
 template <class T> class Polynomial
 {
 private:
     vector<T> coefficients;
 
+    static void multiply(const T *a, size_t a_size, const T *b, size_t b_size, T *out);
+    static void multiply_schoolbook(const T *a, size_t a_size, const T *b, size_t b_size, T *out);
+    static void multiply_karatsuba(const T *a, const T *b, size_t size, T *out, T *scratch);
+    static size_t karatsuba_scratch(size_t size);
+    static void inverse_series(const T *f, size_t f_size, size_t length, T *g);
+    static void divide_long(vector<T> &remainder, const T *div, size_t div_size, T *quotient);
+    static void divide_newton(const vector<T> &dividend, const T *div, size_t div_size, T *quotient);
+    static Polynomial<T> from_coefficients(vector<T> &values);
+
+    struct Matrix;
+    static Matrix identity();
+    static Matrix step(const Polynomial<T> &quotient);
+    static Matrix product(const Matrix &left, const Matrix &right);
+    static void apply(const Matrix &m, Polynomial<T> &a, Polynomial<T> &b);
+    Polynomial<T> shifted(int k) const;
+    static Matrix euclid(Polynomial<T> &a, Polynomial<T> &b, int stop);
+    static Matrix half_gcd(const Polynomial<T> &a, const Polynomial<T> &b);
+    static Matrix gcd_matrix(Polynomial<T> &a, Polynomial<T> &b);
+    static void remainders(Polynomial<T> &a, Polynomial<T> &b, int stop);
+    static void half_reduce(Polynomial<T> &a, Polynomial<T> &b);
+
+    void evaluate_horner(const T *points, size_t count, T *out) const;
+    void evaluate_tree(const T *points, size_t count, T *out) const;
+    void evaluate_serial(const T *points, size_t count, T *out) const;
+
 public:
     Polynomial<T>(const T &scalar);
     template <class S> Polynomial<T>(S begin,  S end);
@@ -36,8 +87,11 @@ public:
     Polynomial <T> &operator /=(Polynomial<T> const &mult);
     Polynomial <T> operator %(Polynomial<T> const &div) const;
     Polynomial <T> &operator %=(Polynomial<T> const &div);
+    void divmod(Polynomial<T> const &div, Polynomial<T> &quotient, Polynomial<T> &remainder) const;
     T operator()(T point) const;
+    void evaluate(const T *points, size_t count, T *out, unsigned threads = 0) const;
     Polynomial <T> operator , (Polynomial <T> const &other) const;
+    Polynomial <T> gcdex(Polynomial <T> const &other, Polynomial <T> &x, Polynomial <T> &y) const;
     ostream & operator <<(ostream &out) const;
     typename vector<T>::iterator begin();
     typename vector<T>::iterator end();
@@ -103,8 +157,9 @@ template <class T> T& Polynomial<T>::operator[] (size_t index)
 }
 template <class T> const T& Polynomial<T>::operator[] (size_t index) const
 {
+    int degree = Degree();
 
-    if (index <= Degree()) {
+    if (degree >= 0 && index <= size_t(degree)) {
         return coefficients[index];
     } else {
         const static T null_element(0);
@@ -143,7 +198,7 @@ template <class T> Polynomial <T> Polynomial<T>::operator -( Polynomial <T> cons
 }
 template <class T> Polynomial <T> Polynomial<T>::operator -() const
 {
-    return (*this * (-1));
+    return (*this * T(-1));
 }
 template <class T> Polynomial <T> & Polynomial<T>::operator -=( Polynomial <T> const &subtrahend)
 {
@@ -160,46 +215,131 @@ template <class T> Polynomial <T> & Polynomial<T>::operator *=( Polynomial <T> c
 {
     int degree = Degree();
     int mult_degree = mult.Degree();
-    Polynomial <T> temp(*this);
 
-    coefficients.clear();
-    for (int i = 0; i <= degree; ++i) {
-        for (int j = 0; j <= mult_degree; ++j) {
-            operator[](i + j) += temp[i] * mult[j];
-        }
+    if (degree < 0 || mult_degree < 0) {
+        coefficients.clear();
+        return *this;
     }
 
+    vector<T> product(degree + mult_degree + 1);
+    multiply(&coefficients[0], degree + 1, &mult.coefficients[0], mult_degree + 1, &product[0]);
+    coefficients.swap(product);
+
     return *this;
 }
-template <class T> Polynomial <T> Polynomial<T>::operator /(Polynomial<T> const &div) const
+/*
+ * out[0, a_size + b_size - 1) = a * b. Schoolbook for short operands, FFT or
+ * NTT from convolution.h for long ones when T allows, otherwise balanced
+ * Karatsuba over pieces of the longer operand the size of the shorter one.
+ */
+template <class T> void Polynomial<T>::multiply(const T *a, size_t a_size, const T *b, size_t b_size, T *out)
 {
-    Polynomial <T> temp = *this;
-    temp /= div;
+    if (a_size < b_size) {
+        std::swap(a, b);
+        std::swap(a_size, b_size);
+    }
+    if (b_size <= KARATSUBA_THRESHOLD) {
+        multiply_schoolbook(a, a_size, b, b_size, out);
+        return;
+    }
+    if (convolve(a, a_size, b, b_size, out)) {
+        return;
+    }
 
-    return temp;
+    size_t out_size = a_size + b_size - 1;
+    for (size_t i = 0; i < out_size; ++i) {
+        out[i] = T(0);
+    }
+
+    vector<T> piece(2 * b_size - 1);
+    vector<T> scratch(karatsuba_scratch(b_size));
+    for (size_t start = 0; start < a_size; start += b_size) {
+        size_t size = std::min(b_size, a_size - start);
+
+        if (size == b_size) {
+            multiply_karatsuba(a + start, b, size, &piece[0], scratch.empty() ? 0 : &scratch[0]);
+        } else {
+            multiply(a + start, size, b, b_size, &piece[0]);
+        }
+        for (size_t i = 0; i < size + b_size - 1; ++i) {
+            out[start + i] += piece[i];
+        }
+    }
 }
-template <class T> Polynomial <T> & Polynomial<T>::operator /=(Polynomial<T> const &div)
+template <class T> void Polynomial<T>::multiply_schoolbook(const T *a, size_t a_size, const T *b, size_t b_size, T *out)
 {
-    int degree = Degree();
-    int div_degree = div.Degree();
-
-    if (degree < div_degree) {
-        return *this = 0;
+    for (size_t i = 0; i < a_size + b_size - 1; ++i) {
+        out[i] = T(0);
+    }
+    for (size_t i = 0; i < a_size; ++i) {
+        for (size_t j = 0; j < b_size; ++j) {
+            out[i + j] += a[i] * b[j];
+        }
+    }
+}
+//elements of scratch multiply_karatsuba needs for operands of size coefficients
+template <class T> size_t Polynomial<T>::karatsuba_scratch(size_t size)
+{
+    if (size <= KARATSUBA_THRESHOLD) {
+        return 0;
+    }
+    size_t high = size - size / 2;
+    return 4 * high + karatsuba_scratch(high);
+}
+/*
+ * out[0, 2 * size - 1) = a * b, both of size coefficients:
+ * (a1 x^h + a0)(b1 x^h + b0) = z2 x^2h + ((a0 + a1)(b0 + b1) - z2 - z0) x^h + z0.
+ * z0 and z2 go straight to out, the middle product to scratch.
+ */
+template <class T> void Polynomial<T>::multiply_karatsuba(const T *a, const T *b, size_t size, T *out, T *scratch)
+{
+    if (size <= KARATSUBA_THRESHOLD) {
+        multiply_schoolbook(a, size, b, size, out);
+        return;
     }
 
-    int result_size = degree - div_degree + 1;
-    vector<T> result;
+    size_t low = size / 2;
+    size_t high = size - low;
+    T *a_sum = scratch;
+    T *b_sum = a_sum + high;
+    T *middle = b_sum + high;
+    T *rest = middle + 2 * high;
 
-    result.assign(result_size, 0);
+    multiply_karatsuba(a, b, low, out, rest);
+    out[2 * low - 1] = T(0);
+    multiply_karatsuba(a + low, b + low, high, out + 2 * low, rest);
 
-    while (degree >= div_degree) {
-        result[degree - div_degree] = operator[](degree) / div[div_degree];
-        Polynomial <T> mult(result.begin(), result.begin() + degree - div_degree);
-        operator -=(mult * div);
-        degree = Degree();
+    for (size_t i = 0; i < high; ++i) {
+        a_sum[i] = a[low + i];
+        b_sum[i] = b[low + i];
+    }
+    for (size_t i = 0; i < low; ++i) {
+        a_sum[i] += a[i];
+        b_sum[i] += b[i];
     }
+    multiply_karatsuba(a_sum, b_sum, high, middle, rest);
 
-    *this = Polynomial(result.begin(), --result.end());
+    for (size_t i = 0; i < 2 * low - 1; ++i) {
+        middle[i] -= out[i];
+    }
+    for (size_t i = 0; i < 2 * high - 1; ++i) {
+        middle[i] -= out[2 * low + i];
+    }
+    for (size_t i = 0; i < 2 * high - 1; ++i) {
+        out[low + i] += middle[i];
+    }
+}
+template <class T> Polynomial <T> Polynomial<T>::operator /(Polynomial<T> const &div) const
+{
+    Polynomial <T> temp = *this;
+    temp /= div;
+
+    return temp;
+}
+template <class T> Polynomial <T> & Polynomial<T>::operator /=(Polynomial<T> const &div)
+{
+    Polynomial <T> remainder(0);
+    divmod(div, *this, remainder);
 
     return *this;
 }
@@ -212,38 +352,489 @@ template <class T> Polynomial <T> Polynomial<T>::operator %(Polynomial<T> const
 }
 template <class T> Polynomial <T> & Polynomial<T>::operator %=(Polynomial<T> const &div)
 {
-    Polynomial <T> mult(*this / div);
-    *this -= (div * mult);
+    Polynomial <T> quotient(0);
+    divmod(div, quotient, *this);
 
     return *this;
 }
+/*
+ * *this = quotient * div + remainder, div must not be zero. Over a field
+ * deg remainder < deg div. For integer types each step divides by the leading
+ * coefficient of div with T division, whatever it leaves stays in the remainder.
+ * Long division, or Newton iteration for long quotients and divisors when the
+ * leading coefficient of div is invertible in T and T is inexact or wraps around.
+ */
+template <class T> void Polynomial<T>::divmod(Polynomial<T> const &div, Polynomial<T> &quotient,
+                                              Polynomial<T> &remainder) const
+{
+    int degree = Degree();
+    int div_degree = div.Degree();
+
+    if (degree < div_degree) {
+        remainder = *this;
+        quotient = T(0);
+        return;
+    }
+
+    size_t quotient_size = degree - div_degree + 1;
+    size_t div_size = div_degree + 1;
+    const T *d = &div.coefficients[0];
+    T lead = d[div_degree];
+    vector<T> q(quotient_size);
+    vector<T> r(coefficients.begin(), coefficients.begin() + degree + 1);
+
+    //the series inverse of an integer polynomial grows exponentially, only wrapping types survive it
+    bool invertible = !std::numeric_limits<T>::is_exact
+            || (std::numeric_limits<T>::is_modulo && lead * (T(1) / lead) == T(1));
+
+    if (quotient_size >= NEWTON_DIVISION_THRESHOLD && div_size >= NEWTON_DIVISION_THRESHOLD && invertible) {
+        divide_newton(r, d, div_size, &q[0]);
+
+        //remainder = dividend - quotient * div, only its low div_degree coefficients are not zero
+        vector<T> product(quotient_size + div_size - 1);
+        multiply(&q[0], quotient_size, d, div_size, &product[0]);
+        r.resize(div_degree);
+        for (int i = 0; i < div_degree; ++i) {
+            r[i] -= product[i];
+        }
+    } else {
+        divide_long(r, d, div_size, &q[0]);
+    }
+
+    quotient = from_coefficients(q);
+    remainder = from_coefficients(r);
+}
+/*
+ * Schoolbook division in place: remainder holds the dividend and is reduced
+ * from the top, one coefficient of quotient per step, O(quotient * div) operations.
+ */
+template <class T> void Polynomial<T>::divide_long(vector<T> &remainder, const T *div, size_t div_size, T *quotient)
+{
+    size_t div_degree = div_size - 1;
+    T lead = div[div_degree];
+
+    for (size_t i = remainder.size() - div_size + 1; i-- > 0; ) {
+        T factor = remainder[i + div_degree] / lead;
+        quotient[i] = factor;
+        if (factor == T(0)) {
+            continue;
+        }
+        for (size_t j = 0; j < div_degree; ++j) {
+            remainder[i + j] -= factor * div[j];
+        }
+        //inexact types would keep rounding noise in the eliminated coefficient
+        if (std::numeric_limits<T>::is_exact) {
+            remainder[i + div_degree] -= factor * lead;
+        } else {
+            remainder[i + div_degree] = T(0);
+        }
+    }
+}
+/*
+ * g[0, length) = 1 / f mod x^length by Newton iteration g = g (2 - f g),
+ * doubling the number of correct coefficients each step; f[0] must be invertible.
+ */
+template <class T> void Polynomial<T>::inverse_series(const T *f, size_t f_size, size_t length, T *g)
+{
+    vector<T> product(2 * length);
+    vector<T> correction(2 * length);
+
+    g[0] = T(1) / f[0];
+    for (size_t done = 1; done < length; ) {
+        size_t next = std::min(2 * done, length);
+        size_t used = std::min(f_size, next);
+
+        //f g = 1 + x^done h mod x^next, then g -= x^done (g h) mod x^next
+        multiply(f, used, g, done, &product[0]);
+        multiply(g, done, &product[done], next - done, &correction[0]);
+        for (size_t i = done; i < next; ++i) {
+            g[i] = T(0) - correction[i - done];
+        }
+        done = next;
+    }
+}
+/*
+ * Quotient by the reversed polynomials: rev(q) = rev(a) / rev(div) mod x^k,
+ * k = deg a - deg div + 1, with the series inverse of rev(div) from
+ * Newton iteration, O(M(n)) with M the cost of multiply.
+ */
+template <class T> void Polynomial<T>::divide_newton(const vector<T> &dividend, const T *div, size_t div_size, T *quotient)
+{
+    size_t size = dividend.size();
+    size_t quotient_size = size - div_size + 1;
+    size_t used = std::min(div_size, quotient_size);
+    vector<T> reversed_div(used);
+    vector<T> reversed_dividend(quotient_size);
+
+    for (size_t i = 0; i < used; ++i) {
+        reversed_div[i] = div[div_size - 1 - i];
+    }
+    for (size_t i = 0; i < quotient_size; ++i) {
+        reversed_dividend[i] = dividend[size - 1 - i];
+    }
+
+    vector<T> inverse(quotient_size);
+    inverse_series(&reversed_div[0], used, quotient_size, &inverse[0]);
+
+    vector<T> product(2 * quotient_size - 1);
+    multiply(&reversed_dividend[0], quotient_size, &inverse[0], quotient_size, &product[0]);
+    for (size_t i = 0; i < quotient_size; ++i) {
+        quotient[i] = product[quotient_size - 1 - i];
+    }
+}
+template <class T> Polynomial<T> Polynomial<T>::from_coefficients(vector<T> &values)
+{
+    Polynomial <T> result(0);
+    if (!values.empty()) {
+        result.coefficients.swap(values);
+    }
+
+    return result;
+}
 template <class T> T Polynomial<T>::operator()(T point) const
 {
     T result = 0;
-    T mult(1);
     int degree = Degree();
 
-    for (int i = 0; i <= degree; ++i) {
-        result += mult * coefficients[i];
-        mult *= point;
+    for (int i = degree; i >= 0; --i) {
+        result = result * point + coefficients[i];
     }
 
     return result;
 }
+/*
+ * out[i] = (*this)(points[i]) for i < count. Batches are split over threads,
+ * hardware_concurrency() for long ones if 0; each chunk is evaluated by Horner's rule
+ * over blocks of points or, for high degrees and many points, by a
+ * subproduct tree.
+ */
+template <class T> void Polynomial<T>::evaluate(const T *points, size_t count, T *out, unsigned threads) const
+{
+    if (!threads && count >= PARALLEL_EVALUATE_MIN_POINTS) {
+        threads = std::thread::hardware_concurrency();
+    }
+    if (threads < 2 || count < 2) {
+        evaluate_serial(points, count, out);
+        return;
+    }
+
+    size_t share = (count + threads - 1) / threads;
+    vector<std::thread> workers;
+    for (size_t start = share; start < count; start += share) {
+        size_t size = std::min(share, count - start);
+        workers.push_back(std::thread(&Polynomial<T>::evaluate_serial, this, points + start, size, out + start));
+    }
+    evaluate_serial(points, std::min(share, count), out);
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+}
+/*
+ * The subproduct tree needs exact arithmetic: remainder trees lose the
+ * accuracy of floating point values and overflow signed integers in the
+ * intermediate products. Only IsExactField types and unsigned integers,
+ * which wrap, take it; everything else is evaluated by Horner's rule.
+ */
+template <class T> void Polynomial<T>::evaluate_serial(const T *points, size_t count, T *out) const
+{
+    const bool exact = IsExactField<T>::value
+            || (std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T, bool>::value);
+
+    if (exact && count >= SUBPRODUCT_THRESHOLD && Degree() >= int(SUBPRODUCT_THRESHOLD)) {
+        evaluate_tree(points, count, out);
+    } else {
+        evaluate_horner(points, count, out);
+    }
+}
+//Horner's rule for HORNER_BLOCK points at once, O(degree * count)
+template <class T> void Polynomial<T>::evaluate_horner(const T *points, size_t count, T *out) const
+{
+    int degree = Degree();
+
+    for (size_t start = 0; start < count; start += HORNER_BLOCK) {
+        size_t size = std::min(HORNER_BLOCK, count - start);
+        T x[HORNER_BLOCK];
+        T result[HORNER_BLOCK];
+
+        for (size_t j = 0; j < HORNER_BLOCK; ++j) {
+            x[j] = (j < size) ? points[start + j] : T(0);
+            result[j] = T(0);
+        }
+        for (int i = degree; i >= 0; --i) {
+            T coefficient = coefficients[i];
+            for (size_t j = 0; j < HORNER_BLOCK; ++j) {
+                result[j] = result[j] * x[j] + coefficient;
+            }
+        }
+        for (size_t j = 0; j < size; ++j) {
+            out[start + j] = result[j];
+        }
+    }
+}
+/*
+ * Multipoint evaluation by a subproduct tree over pieces of degree + 1
+ * points: level 0 holds x - points[i], each level above the products of
+ * pairs. Remainders of *this are taken down the tree, p(points[i]) is the
+ * remainder modulo x - points[i]. O(M(n) log n) per piece.
+ */
+template <class T> void Polynomial<T>::evaluate_tree(const T *points, size_t count, T *out) const
+{
+    size_t piece = Degree() + 1;
+
+    for (size_t start = 0; start < count; start += piece) {
+        size_t size = std::min(piece, count - start);
+        vector<vector<Polynomial<T> > > tree(1);
+
+        for (size_t i = 0; i < size; ++i) {
+            vector<T> linear(2);
+            linear[0] = T(0) - points[start + i];
+            linear[1] = T(1);
+            tree[0].push_back(from_coefficients(linear));
+        }
+        while (tree.back().size() > 1) {
+            const vector<Polynomial<T> > &below = tree.back();
+            vector<Polynomial<T> > level;
+            for (size_t i = 0; i + 1 < below.size(); i += 2) {
+                level.push_back(below[i] * below[i + 1]);
+            }
+            if (below.size() % 2) {
+                level.push_back(below.back());
+            }
+            tree.push_back(level);
+        }
+
+        //remainders[i] belongs to node i of the current level
+        vector<Polynomial<T> > remainders(1, *this % tree.back()[0]);
+        for (size_t level = tree.size() - 1; level-- > 0; ) {
+            vector<Polynomial<T> > next(tree[level].size(), Polynomial<T>(T(0)));
+            for (size_t i = 0; i < tree[level].size(); ++i) {
+                next[i] = remainders[i / 2] % tree[level][i];
+            }
+            remainders.swap(next);
+        }
+        for (size_t i = 0; i < size; ++i) {
+            out[start + i] = remainders[i][0];
+        }
+    }
+}
+/*
+ * Matrix of polynomials taking a pair of remainders (a, b) to
+ * (a' b) = (a11 a12; a21 a22) (a b), a product of Euclidean steps.
+ */
+template <class T> struct Polynomial<T>::Matrix
+{
+    Polynomial <T> a11, a12, a21, a22;
+
+    Matrix(const Polynomial <T> &b11, const Polynomial <T> &b12, const Polynomial <T> &b21, const Polynomial <T> &b22):
+        a11(b11),
+        a12(b12),
+        a21(b21),
+        a22(b22)
+    {
+    }
+};
+template <class T> typename Polynomial<T>::Matrix Polynomial<T>::identity()
+{
+    return Matrix(T(1), T(0), T(0), T(1));
+}
+//(a, b) -> (b, a - quotient * b)
+template <class T> typename Polynomial<T>::Matrix Polynomial<T>::step(const Polynomial<T> &quotient)
+{
+    return Matrix(T(0), T(1), T(1), -quotient);
+}
+template <class T> typename Polynomial<T>::Matrix Polynomial<T>::product(const Matrix &left, const Matrix &right)
+{
+    return Matrix(left.a11 * right.a11 + left.a12 * right.a21, left.a11 * right.a12 + left.a12 * right.a22,
+                  left.a21 * right.a11 + left.a22 * right.a21, left.a21 * right.a12 + left.a22 * right.a22);
+}
+template <class T> void Polynomial<T>::apply(const Matrix &m, Polynomial<T> &a, Polynomial<T> &b)
+{
+    Polynomial <T> first = m.a11 * a + m.a12 * b;
+    b = m.a21 * a + m.a22 * b;
+    a = first;
+}
+//*this divided by x^k, the lower coefficients dropped
+template <class T> Polynomial<T> Polynomial<T>::shifted(int k) const
+{
+    int degree = Degree();
+
+    if (degree < k) {
+        return Polynomial <T>(0);
+    }
+    vector<T> high(coefficients.begin() + k, coefficients.begin() + degree + 1);
+    return from_coefficients(high);
+}
+//Euclidean steps in place while deg b >= stop, returns their product
+template <class T> typename Polynomial<T>::Matrix Polynomial<T>::euclid(Polynomial<T> &a, Polynomial<T> &b, int stop)
+{
+    Matrix m = identity();
+    Polynomial <T> quotient(0);
+    Polynomial <T> remainder(0);
+
+    while (b.Degree() >= 0 && b.Degree() >= stop) {
+        a.divmod(b, quotient, remainder);
+        a.coefficients.swap(b.coefficients);
+        b.coefficients.swap(remainder.coefficients);
+        m = product(step(quotient), m);
+    }
+    return m;
+}
+/*
+ * deg a > deg b. The product of the Euclidean steps taking (a, b) to the
+ * first pair of remainders with deg b < ceil(deg a / 2), found from the
+ * high halves of the polynomials only (Thull and Yap), O(M(n) log n).
+ */
+template <class T> typename Polynomial<T>::Matrix Polynomial<T>::half_gcd(const Polynomial<T> &a, const Polynomial<T> &b)
+{
+    int half = (a.Degree() + 1) / 2;
+
+    if (b.Degree() < half) {
+        return identity();
+    }
+    if (a.Degree() < HALF_GCD_THRESHOLD) {
+        Polynomial <T> x(a);
+        Polynomial <T> y(b);
+        return euclid(x, y, half);
+    }
+
+    Matrix r = half_gcd(a.shifted(half), b.shifted(half));
+    Polynomial <T> x(a);
+    Polynomial <T> y(b);
+    apply(r, x, y);
+    if (y.Degree() < half) {
+        return r;
+    }
+
+    Polynomial <T> quotient(0);
+    Polynomial <T> remainder(0);
+    x.divmod(y, quotient, remainder);
+    r = product(step(quotient), r);
+    if (remainder.Degree() < half) {
+        return r;
+    }
+
+    int k = 2 * half - y.Degree();
+    return product(half_gcd(y.shifted(k), remainder.shifted(k)), r);
+}
+/*
+ * deg a > deg b or b == 0. Reduces (a, b) in place to (gcd, 0), up to a
+ * constant factor, and returns the product of the steps.
+ */
+template <class T> typename Polynomial<T>::Matrix Polynomial<T>::gcd_matrix(Polynomial<T> &a, Polynomial<T> &b)
+{
+    if (a.Degree() < HALF_GCD_THRESHOLD) {
+        return euclid(a, b, 0);
+    }
+
+    Matrix r = half_gcd(a, b);
+    apply(r, a, b);
+    if (b.Degree() < 0) {
+        return r;
+    }
+
+    Polynomial <T> quotient(0);
+    Polynomial <T> remainder(0);
+    a.divmod(b, quotient, remainder);
+    a = b;
+    b = remainder;
+    r = product(step(quotient), r);
+
+    return product(gcd_matrix(a, b), r);
+}
+//euclid without the matrix: only the remainders are kept
+template <class T> void Polynomial<T>::remainders(Polynomial<T> &a, Polynomial<T> &b, int stop)
+{
+    Polynomial <T> quotient(0);
+    Polynomial <T> remainder(0);
+
+    while (b.Degree() >= 0 && b.Degree() >= stop) {
+        a.divmod(b, quotient, remainder);
+        a.coefficients.swap(b.coefficients);
+        b.coefficients.swap(remainder.coefficients);
+    }
+}
+/*
+ * deg a > deg b. Takes (a, b) in place to the pair half_gcd(a, b) leads
+ * to, applying the matrices of its two halves to the remainders directly
+ * instead of multiplying them together.
+ */
+template <class T> void Polynomial<T>::half_reduce(Polynomial<T> &a, Polynomial<T> &b)
+{
+    int half = (a.Degree() + 1) / 2;
+
+    if (b.Degree() < half) {
+        return;
+    }
+    if (a.Degree() < HALF_GCD_THRESHOLD) {
+        remainders(a, b, half);
+        return;
+    }
+
+    apply(half_gcd(a.shifted(half), b.shifted(half)), a, b);
+    if (b.Degree() < half) {
+        return;
+    }
+    //one plain step
+    remainders(a, b, b.Degree());
+    if (b.Degree() < half) {
+        return;
+    }
+
+    int k = 2 * half - a.Degree();
+    apply(half_gcd(a.shifted(k), b.shifted(k)), a, b);
+}
 template <class T> Polynomial<T> Polynomial<T>::operator , (Polynomial <T> const &other) const
 {
     Polynomial <T> a(*this);
     Polynomial <T> b(other);
-    Polynomial <T> r(0);
 
-    while (b.Degree() != -1) {
-        r = a % b;
-        a = b;
-        b = r;
+    if (a.Degree() < b.Degree()) {
+        a.coefficients.swap(b.coefficients);
+    }
+    //gcd_matrix without the cofactors: one plain step first to get deg a > deg b
+    remainders(a, b, a.Degree());
+    while (a.Degree() >= HALF_GCD_THRESHOLD && b.Degree() >= 0) {
+        half_reduce(a, b);
+        //one plain step
+        remainders(a, b, b.Degree());
+    }
+    remainders(a, b, 0);
+    if (a.Degree() < 0) {
+        return a;
     }
 
     return a / a[a.Degree()];
 }
+/*
+ * Monic gcd of *this and other with Bezout cofactors:
+ * x * *this + y * other == gcd. Both zero give zero with x = y = 0.
+ */
+template <class T> Polynomial<T> Polynomial<T>::gcdex(Polynomial <T> const &other, Polynomial <T> &x, Polynomial <T> &y) const
+{
+    Polynomial <T> a(*this);
+    Polynomial <T> b(other);
+    bool swapped = a.Degree() < b.Degree();
+
+    if (swapped) {
+        a.coefficients.swap(b.coefficients);
+    }
+    Matrix m = euclid(a, b, a.Degree());
+    m = product(gcd_matrix(a, b), m);
+
+    if (swapped) {
+        std::swap(m.a11, m.a12);
+    }
+    if (a.Degree() < 0) {
+        x = T(0);
+        y = T(0);
+        return a;
+    }
+
+    Polynomial <T> lead(a[a.Degree()]);
+    x = m.a11 / lead;
+    y = m.a12 / lead;
+    return a / lead;
+}
 template <class T> ostream & Polynomial<T>::operator <<(ostream &out) const
 {
     int degree = Degree();
@@ -1,9 +1,13 @@
 TEMPLATE = app
 CONFIG += console
+CONFIG += thread
 CONFIG -= qt
 
+QMAKE_CXXFLAGS += -std=c++11
+
 SOURCES += main.cpp
 
 HEADERS += \
-    polynomial.h
+    polynomial.h \
+    convolution.h
 